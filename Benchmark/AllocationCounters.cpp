@@ -0,0 +1,339 @@
+#include "AllocationCounters.h"
+
+#if defined(__linux__)
+#include <malloc.h>
+#elif defined(_WIN32)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+// STL
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+// glibc's own allocator, which the malloc() family defined below forwards to
+extern "C" void* __libc_malloc(std::size_t size);
+extern "C" void* __libc_calloc(std::size_t count, std::size_t size);
+extern "C" void* __libc_realloc(void* pointer, std::size_t size);
+extern "C" void* __libc_memalign(std::size_t alignment, std::size_t size);
+extern "C" void __libc_free(void* pointer);
+#endif
+
+namespace
+{
+
+// Plain globals with constant initialization: operator new can run before any dynamic initializer
+std::atomic<bool> counting(false);
+std::atomic<std::uint64_t> numberOfAllocations(0);
+std::atomic<std::uint64_t> allocatedBytes(0);
+
+/** Relative to the level at Start(), so it can go negative when memory allocated before is freed. */
+std::atomic<std::int64_t> liveBytes(0);
+std::atomic<std::int64_t> peakLiveBytes(0);
+
+std::size_t GetBlockSize(void* const pointer)
+{
+#if defined(__linux__)
+  return malloc_usable_size(pointer);
+#elif defined(_WIN32)
+  return _msize(pointer);
+#elif defined(__APPLE__)
+  return malloc_size(pointer);
+#else
+  (void)pointer;
+  return 0;
+#endif
+}
+
+void CountAllocation(void* const pointer, const std::size_t size)
+{
+  if(!counting.load(std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  numberOfAllocations.fetch_add(1, std::memory_order_relaxed);
+  allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+
+  const std::int64_t blockSize = static_cast<std::int64_t>(GetBlockSize(pointer));
+  const std::int64_t live = liveBytes.fetch_add(blockSize, std::memory_order_relaxed) + blockSize;
+  std::int64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+  while(live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+  {
+  }
+}
+
+void CountDeallocation(void* const pointer)
+{
+  if(pointer && counting.load(std::memory_order_relaxed))
+  {
+    liveBytes.fetch_sub(GetBlockSize(pointer), std::memory_order_relaxed);
+  }
+}
+
+/** A block of the C library allocator, not counted (unlike with malloc() on glibc, see below). */
+void* AllocateBlock(const std::size_t size)
+{
+#if defined(__GLIBC__)
+  return __libc_malloc(size);
+#else
+  return std::malloc(size);
+#endif
+}
+
+void FreeBlock(void* const pointer)
+{
+#if defined(__GLIBC__)
+  __libc_free(pointer);
+#else
+  std::free(pointer);
+#endif
+}
+
+/** What operator new does: retry through the new handler until it gives up; NULL then. */
+void* Allocate(std::size_t size)
+{
+  if(size == 0)
+  {
+    size = 1;
+  }
+
+  while(true)
+  {
+    void* const pointer = AllocateBlock(size);
+    if(pointer)
+    {
+      CountAllocation(pointer, size);
+      return pointer;
+    }
+
+    std::new_handler handler = std::get_new_handler();
+    if(!handler)
+    {
+      return NULL;
+    }
+    handler();
+  }
+}
+
+void* AllocateOrThrow(const std::size_t size)
+{
+  void* const pointer = Allocate(size);
+  if(!pointer)
+  {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+void* AllocateNoThrow(const std::size_t size)
+{
+  try
+  {
+    return Allocate(size);
+  }
+  catch(...)
+  {
+    return NULL;
+  }
+}
+
+void Deallocate(void* const pointer)
+{
+  CountDeallocation(pointer);
+  FreeBlock(pointer);
+}
+
+} // end anonymous namespace
+
+void* operator new(std::size_t size)
+{
+  return AllocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size)
+{
+  return AllocateOrThrow(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return AllocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return AllocateNoThrow(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+  Deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+  Deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+  Deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+  Deallocate(pointer);
+}
+
+// Called instead of the above when the compiler knows the size (C++14 sized deallocation)
+void operator delete(void* pointer, std::size_t) noexcept
+{
+  Deallocate(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+  Deallocate(pointer);
+}
+
+#if defined(__GLIBC__)
+// The C allocation functions, for code that calls them directly. Once the executable defines malloc, free,
+// calloc and realloc, glibc uses them for the whole process; the aligned ones are replaced too, so that every
+// block given to free() was counted. valloc() and pvalloc() are left to glibc.
+extern "C" void* malloc(std::size_t size) noexcept
+{
+  void* const pointer = __libc_malloc(size);
+  if(pointer)
+  {
+    CountAllocation(pointer, size);
+  }
+  return pointer;
+}
+
+extern "C" void free(void* pointer) noexcept
+{
+  CountDeallocation(pointer);
+  __libc_free(pointer);
+}
+
+extern "C" void* calloc(std::size_t count, std::size_t size) noexcept
+{
+  void* const pointer = __libc_calloc(count, size);
+  if(pointer)
+  {
+    CountAllocation(pointer, count * size);
+  }
+  return pointer;
+}
+
+/** Counted as freeing the old block and allocating the new one. */
+extern "C" void* realloc(void* pointer, std::size_t size) noexcept
+{
+  if(!pointer)
+  {
+    return malloc(size);
+  }
+  if(size == 0)
+  {
+    // What glibc's realloc() does too
+    free(pointer);
+    return NULL;
+  }
+  if(!counting.load(std::memory_order_relaxed))
+  {
+    return __libc_realloc(pointer, size);
+  }
+
+  const std::int64_t oldBlockSize = static_cast<std::int64_t>(GetBlockSize(pointer));
+  void* const newPointer = __libc_realloc(pointer, size);
+  if(newPointer)
+  {
+    liveBytes.fetch_sub(oldBlockSize, std::memory_order_relaxed);
+    CountAllocation(newPointer, size);
+  }
+  return newPointer;
+}
+
+extern "C" void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+  void* const pointer = __libc_memalign(alignment, size);
+  if(pointer)
+  {
+    CountAllocation(pointer, size);
+  }
+  return pointer;
+}
+
+extern "C" void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+  return memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void** result, std::size_t alignment, std::size_t size) noexcept
+{
+  if(alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+  {
+    return EINVAL;
+  }
+  void* const pointer = memalign(alignment, size);
+  if(!pointer)
+  {
+    return ENOMEM;
+  }
+  *result = pointer;
+  return 0;
+}
+#endif
+
+AllocationCounters::AllocationCounters() :
+  m_NumberOfAllocations(0), m_AllocatedBytes(0), m_PeakLiveBytes(0)
+{
+}
+
+void AllocationCounters::Start()
+{
+  numberOfAllocations.store(0, std::memory_order_relaxed);
+  allocatedBytes.store(0, std::memory_order_relaxed);
+  liveBytes.store(0, std::memory_order_relaxed);
+  peakLiveBytes.store(0, std::memory_order_relaxed);
+  counting.store(true, std::memory_order_seq_cst);
+}
+
+void AllocationCounters::Stop()
+{
+  counting.store(false, std::memory_order_seq_cst);
+  m_NumberOfAllocations += numberOfAllocations.load(std::memory_order_relaxed);
+  m_AllocatedBytes += allocatedBytes.load(std::memory_order_relaxed);
+  m_PeakLiveBytes = std::max<double>(m_PeakLiveBytes, peakLiveBytes.load(std::memory_order_relaxed));
+}
+
+double AllocationCounters::GetNumberOfAllocations() const
+{
+  return m_NumberOfAllocations;
+}
+
+double AllocationCounters::GetAllocatedBytes() const
+{
+  return m_AllocatedBytes;
+}
+
+double AllocationCounters::GetPeakLiveBytes() const
+{
+  return m_PeakLiveBytes;
+}
+
+bool AllocationCounters::IsPeakLiveBytesAvailable()
+{
+#if defined(__linux__) || defined(_WIN32) || defined(__APPLE__)
+  return true;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,49 @@
+/**
+ * Heap allocations in the measured region of a benchmark case.
+ *
+ * AllocationCounters.cpp replaces the global operator new and delete (every form but the C++17 aligned ones)
+ * of the BenchmarkRunner, so everything allocated with new, including by the standard containers and ITK,
+ * goes through them. Between Start() and Stop() they count the allocations and the bytes requested, and
+ * follow the bytes allocated and not yet freed ("live") to find their peak. Allocations of every thread
+ * are counted, so the workers of a multi-threaded case are included.
+ *
+ * With glibc, malloc(), calloc(), realloc(), free() and the aligned allocation functions are replaced too,
+ * forwarding to glibc's own (__libc_malloc() and the like), so the C allocations of ITK and the C library are
+ * counted as well; a realloc() counts as one allocation. Elsewhere only the C++ allocations are counted.
+ *
+ * Live bytes need the size of the block being freed, which the plain operator delete isn't given; it is
+ * asked from the C library (malloc_usable_size(), _msize() or malloc_size()), so it includes the
+ * allocator's rounding. Where none of those exist, IsPeakLiveBytesAvailable() is false.
+ *
+ * Only one AllocationCounters may be started at a time.
+ */
+
+#ifndef AllocationCounters_h
+#define AllocationCounters_h
+
+class AllocationCounters
+{
+public:
+  AllocationCounters();
+
+  /** Counting happens between Start() and Stop(); successive Start()/Stop() pairs accumulate. */
+  void Start();
+  void Stop();
+
+  double GetNumberOfAllocations() const;
+
+  /** The sum of the sizes requested. */
+  double GetAllocatedBytes() const;
+
+  /** The largest increase of the live bytes over their level at a Start(), in any Start()/Stop() pair. */
+  double GetPeakLiveBytes() const;
+
+  static bool IsPeakLiveBytesAvailable();
+
+private:
+  double m_NumberOfAllocations;
+  double m_AllocatedBytes;
+  double m_PeakLiveBytes;
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include "BenchmarkComparison.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <map>
+
+BenchmarkComparisonSettings::BenchmarkComparisonSettings() : RegressionThreshold(0.05), SignificanceLevel(0.05)
+{
+}
+
+BenchmarkComparison::BenchmarkComparison() :
+  BaselineMedian(0), ContenderMedian(0), RelativeChange(0), PValue(1), Verdict(Unchanged)
+{
+}
+
+double MannWhitneyUTest(const std::vector<double>& a, const std::vector<double>& b)
+{
+  const double n1 = a.size();
+  const double n2 = b.size();
+  if(a.empty() || b.empty())
+  {
+    return 1;
+  }
+
+  // Rank the pooled samples, giving tied values the average of their ranks
+  std::vector<std::pair<double, unsigned int> > pooled; // (value, which sample)
+  for(size_t i = 0; i < a.size(); ++i)
+  {
+    pooled.push_back(std::make_pair(a[i], 0u));
+  }
+  for(size_t i = 0; i < b.size(); ++i)
+  {
+    pooled.push_back(std::make_pair(b[i], 1u));
+  }
+  std::sort(pooled.begin(), pooled.end());
+
+  const double n = pooled.size();
+  double rankSumA = 0;
+  double tieCorrection = 0; // sum of (t^3 - t) over groups of t tied values
+
+  size_t i = 0;
+  while(i < pooled.size())
+  {
+    size_t j = i;
+    while(j + 1 < pooled.size() && pooled[j + 1].first == pooled[i].first)
+    {
+      ++j;
+    }
+
+    const double averageRank = (i + j) / 2.0 + 1;
+    for(size_t k = i; k <= j; ++k)
+    {
+      if(pooled[k].second == 0)
+      {
+        rankSumA += averageRank;
+      }
+    }
+
+    const double t = j - i + 1;
+    tieCorrection += t * t * t - t;
+    i = j + 1;
+  }
+
+  const double u = rankSumA - n1 * (n1 + 1) / 2;
+  const double mean = n1 * n2 / 2;
+  const double variance = n1 * n2 / 12 * ((n + 1) - tieCorrection / (n * (n - 1)));
+  if(variance <= 0)
+  {
+    return 1;
+  }
+
+  const double z = std::max(0.0, std::fabs(u - mean) - 0.5) / std::sqrt(variance);
+  return std::erfc(z / std::sqrt(2.0));
+}
+
+std::vector<BenchmarkComparison> CompareReports(const BenchmarkReport& baseline, const BenchmarkReport& contender,
+                                                const BenchmarkComparisonSettings& settings)
+{
+  std::map<std::string, const BenchmarkResult*> contenderResults;
+  for(size_t i = 0; i < contender.Results.size(); ++i)
+  {
+    contenderResults[contender.Results[i].GetKey()] = &contender.Results[i];
+  }
+
+  std::vector<BenchmarkComparison> comparisons;
+
+  for(size_t i = 0; i < baseline.Results.size(); ++i)
+  {
+    const BenchmarkResult& baselineResult = baseline.Results[i];
+
+    BenchmarkComparison comparison;
+    comparison.Key = baselineResult.GetKey();
+    comparison.BaselineMedian = baselineResult.Statistics.Median;
+
+    std::map<std::string, const BenchmarkResult*>::iterator match = contenderResults.find(comparison.Key);
+    if(match == contenderResults.end())
+    {
+      comparison.Verdict = BenchmarkComparison::OnlyInBaseline;
+      comparisons.push_back(comparison);
+      continue;
+    }
+
+    const BenchmarkResult& contenderResult = *match->second;
+    contenderResults.erase(match);
+
+    comparison.ContenderMedian = contenderResult.Statistics.Median;
+    if(comparison.BaselineMedian > 0)
+    {
+      comparison.RelativeChange = comparison.ContenderMedian / comparison.BaselineMedian - 1;
+    }
+    comparison.PValue = MannWhitneyUTest(baselineResult.Samples, contenderResult.Samples);
+
+    if(comparison.PValue < settings.SignificanceLevel)
+    {
+      if(comparison.RelativeChange > settings.RegressionThreshold)
+      {
+        comparison.Verdict = BenchmarkComparison::Regression;
+      }
+      else if(comparison.RelativeChange < -settings.RegressionThreshold)
+      {
+        comparison.Verdict = BenchmarkComparison::Improvement;
+      }
+    }
+
+    comparisons.push_back(comparison);
+  }
+
+  // Keep the contender's order for the cases the baseline didn't have
+  for(size_t i = 0; i < contender.Results.size(); ++i)
+  {
+    if(contenderResults.count(contender.Results[i].GetKey()) > 0)
+    {
+      BenchmarkComparison comparison;
+      comparison.Key = contender.Results[i].GetKey();
+      comparison.ContenderMedian = contender.Results[i].Statistics.Median;
+      comparison.Verdict = BenchmarkComparison::OnlyInContender;
+      comparisons.push_back(comparison);
+    }
+  }
+
+  return comparisons;
+}
+
+static void PrintBuildDifference(std::ostream& output, const char* name,
+                                 const std::string& baseline, const std::string& contender)
+{
+  if(baseline != contender)
+  {
+    output << "  " << name << ": " << baseline << " -> " << contender << std::endl;
+  }
+}
+
+static const char* GetVerdictName(const BenchmarkComparison::VerdictType verdict)
+{
+  switch(verdict)
+  {
+    case BenchmarkComparison::Regression: return "REGRESSION";
+    case BenchmarkComparison::Improvement: return "improvement";
+    case BenchmarkComparison::OnlyInBaseline: return "only in baseline";
+    case BenchmarkComparison::OnlyInContender: return "only in contender";
+    default: return "";
+  }
+}
+
+unsigned int PrintComparison(std::ostream& output, const BenchmarkReport& baseline, const BenchmarkReport& contender,
+                             const std::vector<BenchmarkComparison>& comparisons)
+{
+  output << "Baseline:  " << baseline.BuildInformation.Date << std::endl;
+  output << "Contender: " << contender.BuildInformation.Date << std::endl;
+  PrintBuildDifference(output, "ITK version", baseline.BuildInformation.ITKVersion, contender.BuildInformation.ITKVersion);
+  PrintBuildDifference(output, "Compiler", baseline.BuildInformation.Compiler, contender.BuildInformation.Compiler);
+  PrintBuildDifference(output, "Compiler flags", baseline.BuildInformation.CompilerFlags, contender.BuildInformation.CompilerFlags);
+  PrintBuildDifference(output, "Build type", baseline.BuildInformation.BuildType, contender.BuildInformation.BuildType);
+  PrintBuildDifference(output, "System", baseline.BuildInformation.System, contender.BuildInformation.System);
+  output << std::endl;
+
+  unsigned int numberOfRegressions = 0;
+
+  std::ios_base::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+  output << std::fixed;
+
+  for(size_t i = 0; i < comparisons.size(); ++i)
+  {
+    const BenchmarkComparison& comparison = comparisons[i];
+    output << comparison.Key << std::endl << "  ";
+
+    if(comparison.Verdict == BenchmarkComparison::OnlyInBaseline ||
+       comparison.Verdict == BenchmarkComparison::OnlyInContender)
+    {
+      output << GetVerdictName(comparison.Verdict) << std::endl;
+      continue;
+    }
+
+    output << std::setprecision(2)
+           << "Median ns/iteration: " << comparison.BaselineMedian * 1e9 << " -> " << comparison.ContenderMedian * 1e9
+           << "  Change: " << std::showpos << comparison.RelativeChange * 100 << "%" << std::noshowpos
+           << std::setprecision(4) << "  p: " << comparison.PValue
+           << "  " << GetVerdictName(comparison.Verdict) << std::endl;
+
+    if(comparison.Verdict == BenchmarkComparison::Regression)
+    {
+      ++numberOfRegressions;
+    }
+  }
+
+  output.flags(flags);
+  output.precision(precision);
+
+  output << std::endl << numberOfRegressions << " significant regression(s)" << std::endl;
+  return numberOfRegressions;
+}
@@ -0,0 +1,69 @@
+/**
+ * Compare two benchmark reports (e.g. before and after an ITK upgrade or a compiler change)
+ * and flag the cases that got significantly slower or faster.
+ *
+ * A case is a regression if its median time per iteration grew by more than RegressionThreshold
+ * AND a two-sided Mann-Whitney U test on the two sets of samples rejects "same distribution" at
+ * SignificanceLevel. The rank test makes no normality assumption, which timing samples (skewed,
+ * with outliers) don't satisfy. The threshold keeps tiny but consistent differences from being flagged.
+ */
+
+#ifndef BenchmarkComparison_h
+#define BenchmarkComparison_h
+
+#include "BenchmarkReport.h"
+
+// STL
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BenchmarkComparisonSettings
+{
+  BenchmarkComparisonSettings();
+
+  /** Relative change of the median that is considered meaningful, e.g. 0.05 for 5%. */
+  double RegressionThreshold;
+
+  double SignificanceLevel;
+};
+
+struct BenchmarkComparison
+{
+  enum VerdictType
+  {
+    Unchanged,
+    Regression,
+    Improvement,
+    OnlyInBaseline,
+    OnlyInContender
+  };
+
+  BenchmarkComparison();
+
+  /** See BenchmarkResult::GetKey() */
+  std::string Key;
+
+  /** Seconds per iteration */
+  double BaselineMedian;
+  double ContenderMedian;
+
+  /** ContenderMedian / BaselineMedian - 1, so positive is slower. */
+  double RelativeChange;
+
+  double PValue;
+
+  VerdictType Verdict;
+};
+
+/** Two-sided p-value of the Mann-Whitney U test (normal approximation with tie and continuity correction). */
+double MannWhitneyUTest(const std::vector<double>& a, const std::vector<double>& b);
+
+std::vector<BenchmarkComparison> CompareReports(const BenchmarkReport& baseline, const BenchmarkReport& contender,
+                                                const BenchmarkComparisonSettings& settings);
+
+/** Print the build differences and a table of the comparisons. Returns the number of regressions. */
+unsigned int PrintComparison(std::ostream& output, const BenchmarkReport& baseline, const BenchmarkReport& contender,
+                             const std::vector<BenchmarkComparison>& comparisons);
+
+#endif
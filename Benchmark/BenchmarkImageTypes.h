@@ -0,0 +1,209 @@
+/**
+ * The pixel type and dimension matrix that image benchmark cases are instantiated for.
+ *
+ * A demo whose case functions are templates on the image type registers them for every
+ * combination with ForEachImageType(), as "<Demo>/<Variant>/<pixel type>/<dimension>D",
+ * e.g. "GetPixelVsIterator/Iterator/float/3D":
+ *
+ *   struct Registrar
+ *   {
+ *     BenchmarkRegistry& Registry;
+ *
+ *     template <typename TImage>
+ *     void Register() const
+ *     {
+ *       Registry.Add("Demo/Variant/" + GetImageTypeName<TImage>(), VariantCase<TImage>, 100);
+ *     }
+ *   };
+ *
+ *   Registrar registrar = {registry};
+ *   ForEachImageType(registrar);
+ *
+ * Kernels that sum or compare pixels use BenchmarkPixelTraits, so the same code handles scalar
+ * and multi-component pixels.
+ */
+
+#ifndef BenchmarkImageTypes_h
+#define BenchmarkImageTypes_h
+
+// ITK
+#include "itkCovariantVector.h"
+#include "itkImage.h"
+#include "itkRGBPixel.h"
+
+// STL
+#include <cmath>
+#include <sstream>
+#include <string>
+
+/** Scalar pixels are summed into a wider type (as the original demos summed unsigned char into unsigned int). */
+template <typename TPixel, typename TAccumulate>
+struct BenchmarkScalarPixelTraits
+{
+  typedef TAccumulate AccumulateType;
+
+  static TPixel MakePixel(const double value)
+  {
+    return static_cast<TPixel>(value);
+  }
+
+  static AccumulateType GetZero()
+  {
+    return 0;
+  }
+
+  static void Accumulate(AccumulateType& sum, const TPixel& pixel)
+  {
+    sum += pixel;
+  }
+
+  static double GetSum(const AccumulateType& sum)
+  {
+    return sum;
+  }
+};
+
+/** Multi-component pixels are summed component-wise; GetSum() adds up the components. */
+template <typename TPixel, typename TAccumulate>
+struct BenchmarkMultiComponentPixelTraits
+{
+  typedef TAccumulate AccumulateType;
+
+  static TPixel MakePixel(const double value)
+  {
+    TPixel pixel;
+    pixel.Fill(static_cast<typename TPixel::ValueType>(value));
+    return pixel;
+  }
+
+  static AccumulateType GetZero()
+  {
+    AccumulateType zero;
+    zero.Fill(0);
+    return zero;
+  }
+
+  static void Accumulate(AccumulateType& sum, const TPixel& pixel)
+  {
+    for(unsigned int component = 0; component < TPixel::Length; ++component)
+    {
+      sum[component] += pixel[component];
+    }
+  }
+
+  static double GetSum(const AccumulateType& sum)
+  {
+    double total = 0;
+    for(unsigned int component = 0; component < TPixel::Length; ++component)
+    {
+      total += sum[component];
+    }
+    return total;
+  }
+};
+
+template <typename TPixel>
+struct BenchmarkPixelTraits;
+
+template <>
+struct BenchmarkPixelTraits<unsigned char> : public BenchmarkScalarPixelTraits<unsigned char, unsigned int>
+{
+  static const char* GetName() { return "uint8"; }
+};
+
+template <>
+struct BenchmarkPixelTraits<unsigned short> : public BenchmarkScalarPixelTraits<unsigned short, unsigned int>
+{
+  static const char* GetName() { return "uint16"; }
+};
+
+template <>
+struct BenchmarkPixelTraits<float> : public BenchmarkScalarPixelTraits<float, double>
+{
+  static const char* GetName() { return "float"; }
+};
+
+template <>
+struct BenchmarkPixelTraits<double> : public BenchmarkScalarPixelTraits<double, double>
+{
+  static const char* GetName() { return "double"; }
+};
+
+template <>
+struct BenchmarkPixelTraits<itk::RGBPixel<unsigned char> > :
+  public BenchmarkMultiComponentPixelTraits<itk::RGBPixel<unsigned char>, itk::RGBPixel<unsigned int> >
+{
+  static const char* GetName() { return "RGB"; }
+};
+
+template <>
+struct BenchmarkPixelTraits<itk::CovariantVector<float, 3> > :
+  public BenchmarkMultiComponentPixelTraits<itk::CovariantVector<float, 3>, itk::CovariantVector<double, 3> >
+{
+  static const char* GetName() { return "CovariantVector"; }
+};
+
+/** e.g. "uint16/3D" */
+template <typename TImage>
+std::string GetImageTypeName()
+{
+  std::stringstream name;
+  name << BenchmarkPixelTraits<typename TImage::PixelType>::GetName() << "/" << TImage::ImageDimension << "D";
+  return name.str();
+}
+
+/** Allocate 'image' with about imageSize^2 pixels, i.e. the same number of pixels as an imageSize x imageSize
+ *  image whatever its dimension, so that an image size sweep covers the same working sets in 2D and 3D. */
+template <typename TImage>
+void AllocateImage(TImage* const image, const unsigned int imageSize)
+{
+  const double numberOfPixels = static_cast<double>(imageSize) * imageSize;
+  const itk::SizeValueType extent =
+    static_cast<itk::SizeValueType>(std::floor(std::pow(numberOfPixels, 1.0 / TImage::ImageDimension) + 0.5));
+
+  typename TImage::IndexType corner;
+  corner.Fill(0);
+  typename TImage::SizeType size;
+  size.Fill(extent > 0 ? extent : 1);
+
+  typename TImage::RegionType region(corner, size);
+  image->SetRegions(region);
+  image->Allocate();
+}
+
+/** Calls registrar.Register<TImage>() for every image type of the matrix. */
+template <typename TRegistrar>
+void ForEachImageType(const TRegistrar& registrar)
+{
+  registrar.template Register<itk::Image<unsigned char, 2> >();
+  registrar.template Register<itk::Image<unsigned short, 2> >();
+  registrar.template Register<itk::Image<float, 2> >();
+  registrar.template Register<itk::Image<double, 2> >();
+  registrar.template Register<itk::Image<itk::RGBPixel<unsigned char>, 2> >();
+  registrar.template Register<itk::Image<itk::CovariantVector<float, 3>, 2> >();
+
+  registrar.template Register<itk::Image<unsigned char, 3> >();
+  registrar.template Register<itk::Image<unsigned short, 3> >();
+  registrar.template Register<itk::Image<float, 3> >();
+  registrar.template Register<itk::Image<double, 3> >();
+  registrar.template Register<itk::Image<itk::RGBPixel<unsigned char>, 3> >();
+  registrar.template Register<itk::Image<itk::CovariantVector<float, 3>, 3> >();
+}
+
+/** Calls registrar.Register<TImage>() for the image types of the matrix with scalar pixels, for kernels that
+ *  order pixels. */
+template <typename TRegistrar>
+void ForEachScalarImageType(const TRegistrar& registrar)
+{
+  registrar.template Register<itk::Image<unsigned char, 2> >();
+  registrar.template Register<itk::Image<unsigned short, 2> >();
+  registrar.template Register<itk::Image<float, 2> >();
+  registrar.template Register<itk::Image<double, 2> >();
+
+  registrar.template Register<itk::Image<unsigned char, 3> >();
+  registrar.template Register<itk::Image<unsigned short, 3> >();
+  registrar.template Register<itk::Image<float, 3> >();
+  registrar.template Register<itk::Image<double, 3> >();
+}
+
+#endif
@@ -0,0 +1,321 @@
+#include "BenchmarkJSON.h"
+
+// STL
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+JSONValue::JSONValue() : m_Type(Null), m_Boolean(false), m_Number(0)
+{
+}
+
+JSONValue::Type JSONValue::GetType() const
+{
+  return m_Type;
+}
+
+bool JSONValue::GetBoolean() const
+{
+  return m_Boolean;
+}
+
+double JSONValue::GetNumber() const
+{
+  return m_Number;
+}
+
+const std::string& JSONValue::GetString() const
+{
+  return m_String;
+}
+
+const std::vector<JSONValue>& JSONValue::GetArray() const
+{
+  return m_Array;
+}
+
+const std::vector<std::pair<std::string, JSONValue> >& JSONValue::GetObject() const
+{
+  return m_Object;
+}
+
+const JSONValue& JSONValue::operator[](const std::string& name) const
+{
+  static const JSONValue null;
+
+  for(size_t i = 0; i < m_Object.size(); ++i)
+  {
+    if(m_Object[i].first == name)
+    {
+      return m_Object[i].second;
+    }
+  }
+  return null;
+}
+
+class JSONParser
+{
+public:
+  explicit JSONParser(const std::string& text) : m_Text(text), m_Position(0)
+  {
+  }
+
+  JSONValue ParseDocument()
+  {
+    JSONValue value = ParseValue();
+    SkipWhitespace();
+    if(m_Position != m_Text.size())
+    {
+      Fail("unexpected trailing characters");
+    }
+    return value;
+  }
+
+private:
+  const std::string& m_Text;
+  size_t m_Position;
+
+  void Fail(const std::string& message) const
+  {
+    std::stringstream stream;
+    stream << "Invalid JSON at offset " << m_Position << ": " << message;
+    throw std::runtime_error(stream.str());
+  }
+
+  void SkipWhitespace()
+  {
+    while(m_Position < m_Text.size() &&
+          (m_Text[m_Position] == ' ' || m_Text[m_Position] == '\t' ||
+           m_Text[m_Position] == '\n' || m_Text[m_Position] == '\r'))
+    {
+      ++m_Position;
+    }
+  }
+
+  char Peek()
+  {
+    SkipWhitespace();
+    if(m_Position >= m_Text.size())
+    {
+      Fail("unexpected end of input");
+    }
+    return m_Text[m_Position];
+  }
+
+  void Expect(const char c)
+  {
+    if(Peek() != c)
+    {
+      Fail(std::string("expected '") + c + "'");
+    }
+    ++m_Position;
+  }
+
+  bool ConsumeLiteral(const char* literal)
+  {
+    std::string expected(literal);
+    if(m_Text.compare(m_Position, expected.size(), expected) == 0)
+    {
+      m_Position += expected.size();
+      return true;
+    }
+    return false;
+  }
+
+  JSONValue ParseValue()
+  {
+    JSONValue value;
+
+    char c = Peek();
+    if(c == '{')
+    {
+      value.m_Type = JSONValue::Object;
+      ++m_Position;
+      if(Peek() == '}')
+      {
+        ++m_Position;
+        return value;
+      }
+      while(true)
+      {
+        if(Peek() != '"')
+        {
+          Fail("expected a member name");
+        }
+        std::string name = ParseString();
+        Expect(':');
+        value.m_Object.push_back(std::make_pair(name, ParseValue()));
+        if(Peek() == ',')
+        {
+          ++m_Position;
+          continue;
+        }
+        Expect('}');
+        return value;
+      }
+    }
+    else if(c == '[')
+    {
+      value.m_Type = JSONValue::Array;
+      ++m_Position;
+      if(Peek() == ']')
+      {
+        ++m_Position;
+        return value;
+      }
+      while(true)
+      {
+        value.m_Array.push_back(ParseValue());
+        if(Peek() == ',')
+        {
+          ++m_Position;
+          continue;
+        }
+        Expect(']');
+        return value;
+      }
+    }
+    else if(c == '"')
+    {
+      value.m_Type = JSONValue::String;
+      value.m_String = ParseString();
+    }
+    else if(ConsumeLiteral("true"))
+    {
+      value.m_Type = JSONValue::Boolean;
+      value.m_Boolean = true;
+    }
+    else if(ConsumeLiteral("false"))
+    {
+      value.m_Type = JSONValue::Boolean;
+      value.m_Boolean = false;
+    }
+    else if(ConsumeLiteral("null"))
+    {
+      value.m_Type = JSONValue::Null;
+    }
+    else
+    {
+      value.m_Type = JSONValue::Number;
+      const char* begin = m_Text.c_str() + m_Position;
+      char* end = NULL;
+      value.m_Number = std::strtod(begin, &end);
+      if(end == begin)
+      {
+        Fail("expected a value");
+      }
+      m_Position += end - begin;
+    }
+
+    return value;
+  }
+
+  std::string ParseString()
+  {
+    Expect('"');
+
+    std::string result;
+    while(true)
+    {
+      if(m_Position >= m_Text.size())
+      {
+        Fail("unterminated string");
+      }
+
+      char c = m_Text[m_Position++];
+      if(c == '"')
+      {
+        return result;
+      }
+      if(c != '\\')
+      {
+        result += c;
+        continue;
+      }
+
+      if(m_Position >= m_Text.size())
+      {
+        Fail("unterminated escape sequence");
+      }
+      char escaped = m_Text[m_Position++];
+      switch(escaped)
+      {
+        case '"': result += '"'; break;
+        case '\\': result += '\\'; break;
+        case '/': result += '/'; break;
+        case 'b': result += '\b'; break;
+        case 'f': result += '\f'; break;
+        case 'n': result += '\n'; break;
+        case 'r': result += '\r'; break;
+        case 't': result += '\t'; break;
+        case 'u':
+        {
+          if(m_Position + 4 > m_Text.size())
+          {
+            Fail("truncated \\u escape");
+          }
+          unsigned long codePoint = std::strtoul(m_Text.substr(m_Position, 4).c_str(), NULL, 16);
+          m_Position += 4;
+          result += codePoint < 128 ? static_cast<char>(codePoint) : '?';
+          break;
+        }
+        default:
+          Fail("invalid escape sequence");
+      }
+    }
+  }
+};
+
+JSONValue JSONValue::Parse(std::istream& input)
+{
+  std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+  JSONParser parser(text);
+  return parser.ParseDocument();
+}
+
+void WriteJSONString(std::ostream& output, const std::string& value)
+{
+  output << '"';
+  for(size_t i = 0; i < value.size(); ++i)
+  {
+    char c = value[i];
+    switch(c)
+    {
+      case '"': output << "\\\""; break;
+      case '\\': output << "\\\\"; break;
+      case '\n': output << "\\n"; break;
+      case '\r': output << "\\r"; break;
+      case '\t': output << "\\t"; break;
+      default:
+        if(static_cast<unsigned char>(c) < 0x20)
+        {
+          char buffer[8];
+          std::sprintf(buffer, "\\u%04x", static_cast<unsigned int>(c));
+          output << buffer;
+        }
+        else
+        {
+          output << c;
+        }
+    }
+  }
+  output << '"';
+}
+
+void WriteJSONNumber(std::ostream& output, const double value)
+{
+  if(std::isnan(value) || std::isinf(value))
+  {
+    output << "null";
+    return;
+  }
+
+  std::streamsize precision = output.precision();
+  output << std::setprecision(std::numeric_limits<double>::digits10 + 2) << value << std::setprecision(precision);
+}
@@ -0,0 +1,62 @@
+/**
+ * Just enough JSON to write benchmark result files and read them back for comparison.
+ * Parsing covers the full grammar except \u escapes outside of the ASCII range.
+ */
+
+#ifndef BenchmarkJSON_h
+#define BenchmarkJSON_h
+
+// STL
+#include <istream>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class JSONValue
+{
+public:
+  enum Type
+  {
+    Null,
+    Boolean,
+    Number,
+    String,
+    Array,
+    Object
+  };
+
+  JSONValue();
+
+  Type GetType() const;
+
+  bool GetBoolean() const;
+  double GetNumber() const;
+  const std::string& GetString() const;
+  const std::vector<JSONValue>& GetArray() const;
+  const std::vector<std::pair<std::string, JSONValue> >& GetObject() const;
+
+  /** The member named 'name' of an object, or a Null value if there is none. */
+  const JSONValue& operator[](const std::string& name) const;
+
+  /** Throws std::runtime_error if 'input' is not valid JSON. */
+  static JSONValue Parse(std::istream& input);
+
+private:
+  Type m_Type;
+  bool m_Boolean;
+  double m_Number;
+  std::string m_String;
+  std::vector<JSONValue> m_Array;
+  std::vector<std::pair<std::string, JSONValue> > m_Object;
+
+  friend class JSONParser;
+};
+
+/** Write 'value' as a quoted and escaped JSON string. */
+void WriteJSONString(std::ostream& output, const std::string& value);
+
+/** Write 'value' as a JSON number (null for NaN and infinity, which JSON can't represent). */
+void WriteJSONNumber(std::ostream& output, const double value);
+
+#endif
@@ -0,0 +1,50 @@
+#include "BenchmarkRegistry.h"
+
+// STL
+#include <regex>
+#include <stdexcept>
+
+void BenchmarkRegistry::Add(const std::string& name, BenchmarkFunction function, const unsigned int defaultImageSize)
+{
+  for(size_t i = 0; i < m_Cases.size(); ++i)
+  {
+    if(m_Cases[i].Name == name)
+    {
+      throw std::runtime_error("A benchmark case named " + name + " is already registered!");
+    }
+  }
+
+  BenchmarkCase benchmarkCase;
+  benchmarkCase.Name = name;
+  benchmarkCase.Function = function;
+  benchmarkCase.DefaultImageSize = defaultImageSize;
+  benchmarkCase.IsMultiThreaded = false;
+  m_Cases.push_back(benchmarkCase);
+}
+
+void BenchmarkRegistry::AddMultiThreaded(const std::string& name, BenchmarkFunction function,
+                                         const unsigned int defaultImageSize)
+{
+  Add(name, function, defaultImageSize);
+  m_Cases.back().IsMultiThreaded = true;
+}
+
+const std::vector<BenchmarkCase>& BenchmarkRegistry::GetCases() const
+{
+  return m_Cases;
+}
+
+std::vector<BenchmarkCase> BenchmarkRegistry::GetMatchingCases(const std::string& filter) const
+{
+  std::regex filterExpression(filter);
+
+  std::vector<BenchmarkCase> matchingCases;
+  for(size_t i = 0; i < m_Cases.size(); ++i)
+  {
+    if(std::regex_search(m_Cases[i].Name, filterExpression))
+    {
+      matchingCases.push_back(m_Cases[i]);
+    }
+  }
+  return matchingCases;
+}
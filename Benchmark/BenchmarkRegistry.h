@@ -0,0 +1,65 @@
+/**
+ * The benchmark registry: every demo registers its variants here as named cases,
+ * so a single BenchmarkRunner can list, filter and run them without recompiling.
+ *
+ * See BenchmarkState.h for how a case runs its measured loop.
+ */
+
+#ifndef BenchmarkRegistry_h
+#define BenchmarkRegistry_h
+
+#include "BenchmarkState.h"
+
+// STL
+#include <string>
+#include <vector>
+
+typedef void (*BenchmarkFunction)(BenchmarkState& state);
+
+struct BenchmarkCase
+{
+  /** Named as <Demo>/<Variant>, e.g. "GetPixelVsIterator/Iterator". */
+  std::string Name;
+
+  BenchmarkFunction Function;
+
+  /** Cases that traverse an image take its extent from BenchmarkState::GetImageSize(), and are run once
+   *  per size of an image size sweep. This is the size used when no sweep is requested; 0 if the case
+   *  does not depend on an image size. */
+  unsigned int DefaultImageSize;
+
+  /** Multi-threaded cases take their number of threads from BenchmarkState::GetNumberOfThreads(), and are
+   *  run once per thread count of a scaling run. */
+  bool IsMultiThreaded;
+};
+
+class BenchmarkRegistry
+{
+public:
+  void Add(const std::string& name, BenchmarkFunction function, const unsigned int defaultImageSize = 0);
+  void AddMultiThreaded(const std::string& name, BenchmarkFunction function, const unsigned int defaultImageSize = 0);
+
+  const std::vector<BenchmarkCase>& GetCases() const;
+
+  /** Returns the cases whose name contains a match for the regular expression 'filter'. */
+  std::vector<BenchmarkCase> GetMatchingCases(const std::string& filter) const;
+
+private:
+  std::vector<BenchmarkCase> m_Cases;
+};
+
+// Each demo provides one of these in its <Demo>Benchmarks.cpp
+void RegisterConditionalVsFullBenchmarks(BenchmarkRegistry& registry);
+void RegisterGetBufferedRegionBenchmarks(BenchmarkRegistry& registry);
+void RegisterGetPixelVsIteratorBenchmarks(BenchmarkRegistry& registry);
+void RegisterImageRegionDifferenceVsVectorBenchmarks(BenchmarkRegistry& registry);
+void RegisterIteratorWithIndexBenchmarks(BenchmarkRegistry& registry);
+void RegisterNeighborhoodIteratorBenchmarks(BenchmarkRegistry& registry);
+void RegisterPatchDistanceBenchmarks(BenchmarkRegistry& registry);
+void RegisterPatchMatchBenchmarks(BenchmarkRegistry& registry);
+void RegisterShapedNeighborhoodIteratorBenchmarks(BenchmarkRegistry& registry);
+void RegisterSquaredNormBenchmarks(BenchmarkRegistry& registry);
+void RegisterTwoIteratorsVsOneIteratorAndGetPixelBenchmarks(BenchmarkRegistry& registry);
+void RegisterVectorImageVsImageCovariantVectorBenchmarks(BenchmarkRegistry& registry);
+
+#endif
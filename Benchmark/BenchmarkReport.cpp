@@ -0,0 +1,372 @@
+#include "BenchmarkReport.h"
+
+#include "BenchmarkBuildInformation.h"
+#include "BenchmarkJSON.h"
+#include "PerformanceCounters.h"
+
+// ITK
+#include "itkVersion.h"
+
+// STL
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/** Reads the cache hierarchy from sysfs (Linux only). */
+static std::string GetCacheSizes()
+{
+  std::string cacheSizes;
+  for(unsigned int cacheId = 0; ; ++cacheId)
+  {
+    std::stringstream directory;
+    directory << "/sys/devices/system/cpu/cpu0/cache/index" << cacheId << "/";
+
+    std::ifstream levelFile((directory.str() + "level").c_str());
+    std::ifstream typeFile((directory.str() + "type").c_str());
+    std::ifstream sizeFile((directory.str() + "size").c_str());
+    std::string level, type, size;
+    if(!(levelFile >> level) || !(typeFile >> type) || !(sizeFile >> size))
+    {
+      break;
+    }
+
+    if(type == "Instruction")
+    {
+      continue;
+    }
+    cacheSizes += (cacheSizes.empty() ? "L" : ", L") + level + (type == "Data" ? "d " : " ") + size;
+  }
+  return cacheSizes;
+}
+
+BenchmarkBuildInformation GetBenchmarkBuildInformation()
+{
+  BenchmarkBuildInformation buildInformation;
+  buildInformation.ITKVersion = itk::Version::GetITKVersion();
+  buildInformation.Compiler = std::string(BENCHMARK_COMPILER_ID) + " " + BENCHMARK_COMPILER_VERSION;
+  buildInformation.CompilerFlags = BENCHMARK_CXX_FLAGS;
+  buildInformation.BuildType = BENCHMARK_BUILD_TYPE;
+  buildInformation.System = BENCHMARK_SYSTEM;
+  buildInformation.CacheSizes = GetCacheSizes();
+
+  char date[32];
+  std::time_t now = std::time(NULL);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  buildInformation.Date = date;
+
+  return buildInformation;
+}
+
+BenchmarkResult::BenchmarkResult() :
+  IterationsPerRepetition(0), ItemsPerIteration(0), BytesPerIteration(0), Checksum(0)
+{
+}
+
+BenchmarkResult::BenchmarkResult(const BenchmarkState& state) :
+  Name(state.GetName()), Parameters(state.GetParameters()),
+  IterationsPerRepetition(state.GetIterationsPerRepetition()),
+  Statistics(state.GetStatistics()), Samples(state.GetSamples()),
+  ItemsPerIteration(state.GetItemsPerIteration()), BytesPerIteration(state.GetBytesPerIteration()),
+  Checksum(state.GetChecksum()), Counters(state.GetPerformanceCounters())
+{
+  const std::map<std::string, double> allocationCounters = state.GetAllocationCounters();
+  Counters.insert(allocationCounters.begin(), allocationCounters.end());
+  Counters.insert(state.GetCounters().begin(), state.GetCounters().end());
+}
+
+double BenchmarkResult::GetItemsPerSecond() const
+{
+  if(Statistics.Median <= 0)
+  {
+    return 0;
+  }
+  return ItemsPerIteration / Statistics.Median;
+}
+
+double BenchmarkResult::GetBytesPerSecond() const
+{
+  if(Statistics.Median <= 0)
+  {
+    return 0;
+  }
+  return BytesPerIteration / Statistics.Median;
+}
+
+std::string BenchmarkResult::GetKey() const
+{
+  if(Parameters.empty())
+  {
+    return Name;
+  }
+
+  std::string key = Name + "[";
+  for(std::map<std::string, std::string>::const_iterator iterator = Parameters.begin();
+      iterator != Parameters.end(); ++iterator)
+  {
+    if(iterator != Parameters.begin())
+    {
+      key += ",";
+    }
+    key += iterator->first + "=" + iterator->second;
+  }
+  return key + "]";
+}
+
+/////////////////////////// JSON ///////////////////////////
+
+static void WriteJSONMember(std::ostream& output, const char* name, const std::string& value)
+{
+  WriteJSONString(output, name);
+  output << ": ";
+  WriteJSONString(output, value);
+}
+
+static void WriteJSONMember(std::ostream& output, const char* name, const double value)
+{
+  WriteJSONString(output, name);
+  output << ": ";
+  WriteJSONNumber(output, value);
+}
+
+void WriteJSONReport(std::ostream& output, const BenchmarkReport& report)
+{
+  const BenchmarkBuildInformation& buildInformation = report.BuildInformation;
+
+  output << "{\n  \"build\": {\n    ";
+  WriteJSONMember(output, "itk_version", buildInformation.ITKVersion);
+  output << ",\n    ";
+  WriteJSONMember(output, "compiler", buildInformation.Compiler);
+  output << ",\n    ";
+  WriteJSONMember(output, "compiler_flags", buildInformation.CompilerFlags);
+  output << ",\n    ";
+  WriteJSONMember(output, "build_type", buildInformation.BuildType);
+  output << ",\n    ";
+  WriteJSONMember(output, "system", buildInformation.System);
+  output << ",\n    ";
+  WriteJSONMember(output, "cache_sizes", buildInformation.CacheSizes);
+  output << ",\n    ";
+  WriteJSONMember(output, "date", buildInformation.Date);
+  output << "\n  },\n  \"benchmarks\": [";
+
+  for(size_t i = 0; i < report.Results.size(); ++i)
+  {
+    const BenchmarkResult& result = report.Results[i];
+    const BenchmarkStatistics& statistics = result.Statistics;
+
+    output << (i == 0 ? "\n" : ",\n") << "    {\n      ";
+    WriteJSONMember(output, "name", result.Name);
+    output << ",\n      \"parameters\": {";
+    for(std::map<std::string, std::string>::const_iterator iterator = result.Parameters.begin();
+        iterator != result.Parameters.end(); ++iterator)
+    {
+      output << (iterator == result.Parameters.begin() ? "" : ", ");
+      WriteJSONMember(output, iterator->first.c_str(), iterator->second);
+    }
+    output << "},\n      ";
+    WriteJSONMember(output, "repetitions", statistics.NumberOfSamples);
+    output << ",\n      ";
+    WriteJSONMember(output, "iterations_per_repetition", result.IterationsPerRepetition);
+    output << ",\n      ";
+    WriteJSONMember(output, "min_ns", statistics.Minimum * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "median_ns", statistics.Median * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "mad_ns", statistics.MedianAbsoluteDeviation * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "mean_ns", statistics.Mean * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "p5_ns", statistics.Percentile5 * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "p25_ns", statistics.Percentile25 * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "p75_ns", statistics.Percentile75 * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "p95_ns", statistics.Percentile95 * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "max_ns", statistics.Maximum * 1e9);
+    output << ",\n      ";
+    WriteJSONMember(output, "items_per_iteration", result.ItemsPerIteration);
+    output << ",\n      ";
+    WriteJSONMember(output, "bytes_per_iteration", result.BytesPerIteration);
+    output << ",\n      ";
+    WriteJSONMember(output, "items_per_second", result.GetItemsPerSecond());
+    output << ",\n      ";
+    WriteJSONMember(output, "bytes_per_second", result.GetBytesPerSecond());
+    output << ",\n      ";
+    WriteJSONMember(output, "checksum", result.Checksum);
+    output << ",\n      \"counters\": {";
+    for(std::map<std::string, double>::const_iterator iterator = result.Counters.begin();
+        iterator != result.Counters.end(); ++iterator)
+    {
+      output << (iterator == result.Counters.begin() ? "" : ", ");
+      WriteJSONMember(output, iterator->first.c_str(), iterator->second);
+    }
+    output << "},\n      \"samples_ns\": [";
+    for(size_t sampleId = 0; sampleId < result.Samples.size(); ++sampleId)
+    {
+      output << (sampleId == 0 ? "" : ", ");
+      WriteJSONNumber(output, result.Samples[sampleId] * 1e9);
+    }
+    output << "]\n    }";
+  }
+
+  output << "\n  ]\n}\n";
+}
+
+BenchmarkReport ReadJSONReport(std::istream& input)
+{
+  JSONValue document = JSONValue::Parse(input);
+  if(document.GetType() != JSONValue::Object || document["benchmarks"].GetType() != JSONValue::Array)
+  {
+    throw std::runtime_error("Not a benchmark report: there is no \"benchmarks\" array!");
+  }
+
+  BenchmarkReport report;
+
+  const JSONValue& build = document["build"];
+  report.BuildInformation.ITKVersion = build["itk_version"].GetString();
+  report.BuildInformation.Compiler = build["compiler"].GetString();
+  report.BuildInformation.CompilerFlags = build["compiler_flags"].GetString();
+  report.BuildInformation.BuildType = build["build_type"].GetString();
+  report.BuildInformation.System = build["system"].GetString();
+  report.BuildInformation.CacheSizes = build["cache_sizes"].GetString();
+  report.BuildInformation.Date = build["date"].GetString();
+
+  const std::vector<JSONValue>& benchmarks = document["benchmarks"].GetArray();
+  for(size_t i = 0; i < benchmarks.size(); ++i)
+  {
+    const JSONValue& benchmark = benchmarks[i];
+
+    BenchmarkResult result;
+    result.Name = benchmark["name"].GetString();
+
+    const std::vector<std::pair<std::string, JSONValue> >& parameters = benchmark["parameters"].GetObject();
+    for(size_t parameterId = 0; parameterId < parameters.size(); ++parameterId)
+    {
+      result.Parameters[parameters[parameterId].first] = parameters[parameterId].second.GetString();
+    }
+
+    result.IterationsPerRepetition = static_cast<unsigned long>(benchmark["iterations_per_repetition"].GetNumber());
+    result.ItemsPerIteration = benchmark["items_per_iteration"].GetNumber();
+    result.BytesPerIteration = benchmark["bytes_per_iteration"].GetNumber();
+    result.Checksum = benchmark["checksum"].GetNumber();
+
+    // Reports written before counters were recorded have no "counters" object
+    if(benchmark["counters"].GetType() == JSONValue::Object)
+    {
+      const std::vector<std::pair<std::string, JSONValue> >& counters = benchmark["counters"].GetObject();
+      for(size_t counterId = 0; counterId < counters.size(); ++counterId)
+      {
+        result.Counters[counters[counterId].first] = counters[counterId].second.GetNumber();
+      }
+    }
+
+    const std::vector<JSONValue>& samples = benchmark["samples_ns"].GetArray();
+    for(size_t sampleId = 0; sampleId < samples.size(); ++sampleId)
+    {
+      result.Samples.push_back(samples[sampleId].GetNumber() * 1e-9);
+    }
+    result.Statistics = ComputeStatistics(result.Samples);
+
+    report.Results.push_back(result);
+  }
+
+  return report;
+}
+
+/////////////////////////// CSV ///////////////////////////
+
+static std::string QuoteCSV(const std::string& value)
+{
+  if(value.find_first_of(",\"\n") == std::string::npos)
+  {
+    return value;
+  }
+
+  std::string quoted = "\"";
+  for(size_t i = 0; i < value.size(); ++i)
+  {
+    if(value[i] == '"')
+    {
+      quoted += '"';
+    }
+    quoted += value[i];
+  }
+  return quoted + "\"";
+}
+
+void WriteCSVReport(std::ostream& output, const BenchmarkReport& report)
+{
+  const BenchmarkBuildInformation& buildInformation = report.BuildInformation;
+
+  output << "name,parameters,itk_version,compiler,compiler_flags,build_type,date,"
+         << "repetitions,iterations_per_repetition,min_ns,median_ns,mad_ns,mean_ns,p5_ns,p25_ns,p75_ns,p95_ns,max_ns,"
+         << "items_per_second,bytes_per_second,checksum";
+  for(unsigned int event = 0; event < PerformanceCounters::NumberOfEvents; ++event)
+  {
+    output << ',' << PerformanceCounters::GetEventName(static_cast<PerformanceCounters::Event>(event));
+  }
+  output << ",ipc,allocations,allocated_bytes,peak_live_bytes\n";
+
+  std::streamsize precision = output.precision();
+  output.precision(10);
+
+  for(size_t i = 0; i < report.Results.size(); ++i)
+  {
+    const BenchmarkResult& result = report.Results[i];
+    const BenchmarkStatistics& statistics = result.Statistics;
+
+    std::string parameters;
+    for(std::map<std::string, std::string>::const_iterator iterator = result.Parameters.begin();
+        iterator != result.Parameters.end(); ++iterator)
+    {
+      parameters += (iterator == result.Parameters.begin() ? "" : ";") + iterator->first + "=" + iterator->second;
+    }
+
+    output << QuoteCSV(result.Name) << ','
+           << QuoteCSV(parameters) << ','
+           << QuoteCSV(buildInformation.ITKVersion) << ','
+           << QuoteCSV(buildInformation.Compiler) << ','
+           << QuoteCSV(buildInformation.CompilerFlags) << ','
+           << QuoteCSV(buildInformation.BuildType) << ','
+           << QuoteCSV(buildInformation.Date) << ','
+           << statistics.NumberOfSamples << ','
+           << result.IterationsPerRepetition << ','
+           << statistics.Minimum * 1e9 << ','
+           << statistics.Median * 1e9 << ','
+           << statistics.MedianAbsoluteDeviation * 1e9 << ','
+           << statistics.Mean * 1e9 << ','
+           << statistics.Percentile5 * 1e9 << ','
+           << statistics.Percentile25 * 1e9 << ','
+           << statistics.Percentile75 * 1e9 << ','
+           << statistics.Percentile95 * 1e9 << ','
+           << statistics.Maximum * 1e9 << ','
+           << result.GetItemsPerSecond() << ','
+           << result.GetBytesPerSecond() << ','
+           << result.Checksum;
+
+    // Counters that weren't collected are left empty
+    std::vector<std::string> counterNames;
+    for(unsigned int event = 0; event < PerformanceCounters::NumberOfEvents; ++event)
+    {
+      counterNames.push_back(PerformanceCounters::GetEventName(static_cast<PerformanceCounters::Event>(event)));
+    }
+    counterNames.push_back("ipc");
+    counterNames.push_back("allocations");
+    counterNames.push_back("allocated_bytes");
+    counterNames.push_back("peak_live_bytes");
+    for(size_t counterId = 0; counterId < counterNames.size(); ++counterId)
+    {
+      std::map<std::string, double>::const_iterator counter = result.Counters.find(counterNames[counterId]);
+      output << ',';
+      if(counter != result.Counters.end())
+      {
+        output << counter->second;
+      }
+    }
+    output << '\n';
+  }
+
+  output.precision(precision);
+}
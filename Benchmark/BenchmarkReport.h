@@ -0,0 +1,88 @@
+/**
+ * Machine-readable benchmark results.
+ *
+ * A result file records the build that produced it (ITK version, compiler, flags) and, for each
+ * case, its name, parameters, timing statistics, throughput, hardware performance counters (if they
+ * were collected) and raw samples. JSON files hold everything and can be read back for comparison
+ * (see BenchmarkComparison.h). CSV files hold one row per case (no samples) for spreadsheets and
+ * plotting.
+ */
+
+#ifndef BenchmarkReport_h
+#define BenchmarkReport_h
+
+#include "BenchmarkState.h"
+#include "BenchmarkStatistics.h"
+
+// STL
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct BenchmarkBuildInformation
+{
+  std::string ITKVersion;
+  std::string Compiler;
+  std::string CompilerFlags;
+  std::string BuildType;
+  std::string System;
+
+  /** The data and unified caches of the first CPU, e.g. "L1d 32K, L2 1024K, L3 32768K"; empty if unknown. */
+  std::string CacheSizes;
+
+  /** When the benchmarks were run, as an ISO 8601 UTC timestamp. */
+  std::string Date;
+};
+
+/** The build information of this executable, timestamped now. */
+BenchmarkBuildInformation GetBenchmarkBuildInformation();
+
+struct BenchmarkResult
+{
+  BenchmarkResult();
+
+  /** Copy everything a finished state measured. */
+  explicit BenchmarkResult(const BenchmarkState& state);
+
+  std::string Name;
+  std::map<std::string, std::string> Parameters;
+
+  unsigned long IterationsPerRepetition;
+
+  /** Seconds per iteration */
+  BenchmarkStatistics Statistics;
+  std::vector<double> Samples;
+
+  double ItemsPerIteration;
+  double BytesPerIteration;
+
+  double Checksum;
+
+  /** Hardware event counts per iteration by event name, e.g. "cycles" or "ipc", and the allocation counters,
+   *  e.g. "allocations", if they were collected, and the values the case set with BenchmarkState::SetCounter(). */
+  std::map<std::string, double> Counters;
+
+  /** Median throughput; zero if the case didn't report what it processes. */
+  double GetItemsPerSecond() const;
+  double GetBytesPerSecond() const;
+
+  /** The name followed by the parameters, e.g. "Demo/Variant[ImageSize=100x100]".
+   *  Results are matched across files by this key. */
+  std::string GetKey() const;
+};
+
+struct BenchmarkReport
+{
+  BenchmarkBuildInformation BuildInformation;
+  std::vector<BenchmarkResult> Results;
+};
+
+void WriteJSONReport(std::ostream& output, const BenchmarkReport& report);
+void WriteCSVReport(std::ostream& output, const BenchmarkReport& report);
+
+/** Throws std::runtime_error if 'input' is not a JSON report written by WriteJSONReport(). */
+BenchmarkReport ReadJSONReport(std::istream& input);
+
+#endif
@@ -0,0 +1,571 @@
+/**
+ * Runs every registered benchmark case, or the ones whose name matches --filter.
+ *
+ * Usage: BenchmarkRunner [options]
+ *
+ *   --list                  Print the names of the matching cases and exit.
+ *   --filter=<regex>        Only run cases whose name contains a match for <regex>,
+ *                           e.g. --filter=GetPixelVsIterator or --filter="/Iterator/float/3D$".
+ *                           Cases of image demos are instantiated for a matrix of pixel types and
+ *                           dimensions (see BenchmarkImageTypes.h) and named <Demo>/<Variant>/<pixel>/<n>D.
+ *   --warmup-time=<s>       Run each case untimed for at least this long first (default 0.1).
+ *   --min-time=<s>          Calibrate repetitions to take at least this long (default 0.01).
+ *   --max-time=<s>          Stop measuring a case after this long (default 2).
+ *   --iterations=<n>        Run exactly <n> iterations per repetition instead of calibrating.
+ *   --repetitions=<n>       Measure exactly <n> repetitions instead of stopping adaptively.
+ *   --json=<file>           Also write the results (with build information and raw samples) as JSON.
+ *   --csv=<file>            Also write the results as CSV, one row per case.
+ *   --image-sizes=<n>[,<n>...]  Run the cases that traverse an image once per image size instead of at
+ *                           their default size. The image has as many pixels as an <n> x <n> image,
+ *                           whatever its dimension.
+ *   --sweep                 Same as --image-sizes=32,64,...,8192: from L1-resident to DRAM-resident
+ *                           working sets. Compare Items/second (pixels) and GB/second across sizes
+ *                           against the cache sizes printed at the start.
+ *   --threads=<n>[,<n>...]  Run the multi-threaded cases once per number of threads (default: one run with
+ *                           as many threads as the hardware has).
+ *   --scaling               Same as --threads=1,2,4,...,<hardware threads>, and print the speedup and parallel
+ *                           efficiency of each multi-threaded case relative to its run with the fewest threads.
+ *   --perf-counters         Also count cycles, instructions, cache/branch/TLB misses per iteration
+ *                           (Linux; see PerformanceCounters.h). Skipped with a warning if unavailable,
+ *                           and for the multi-threaded cases, as only the calling thread is counted.
+ *   --no-allocation-counters  Don't count the heap allocations of the measured loops (see AllocationCounters.h;
+ *                           malloc() is only counted with glibc, new everywhere).
+ *
+ * Comparing results (see BenchmarkComparison.h):
+ *
+ *   --baseline=<file.json>  Compare the results of this run to a previous JSON report...
+ *   --contender=<file.json> ...or, if given too, compare the two reports without running anything.
+ *   --regression-threshold=<fraction>  Smallest relative slowdown that is flagged (default 0.05).
+ *   --significance=<alpha>  Significance level of the Mann-Whitney U test (default 0.05).
+ *
+ * When comparing, the exit code is non-zero if any case regressed.
+ *
+ * After all cases have run, their medians and throughputs are summarized in one table.
+ *
+ * Times are reported per iteration. See BenchmarkState.h for how repetitions are chosen.
+ */
+
+#include "BenchmarkComparison.h"
+#include "BenchmarkRegistry.h"
+#include "BenchmarkReport.h"
+#include "PerformanceCounters.h"
+#include "ThreadPool.h"
+
+// STL
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <string>
+
+static void PrintUsage(const char* executableName)
+{
+  std::cerr << "Usage: " << executableName << " [--list] [--filter=<regex>]"
+            << " [--warmup-time=<s>] [--min-time=<s>] [--max-time=<s>]"
+            << " [--iterations=<n>] [--repetitions=<n>] [--image-sizes=<n>[,<n>...]] [--sweep]"
+            << " [--threads=<n>[,<n>...]] [--scaling]"
+            << " [--json=<file>] [--csv=<file>] [--perf-counters] [--no-allocation-counters]"
+            << " [--baseline=<file.json> [--contender=<file.json>]]"
+            << " [--regression-threshold=<fraction>] [--significance=<alpha>]" << std::endl;
+}
+
+static void RegisterAllBenchmarks(BenchmarkRegistry& registry)
+{
+  RegisterConditionalVsFullBenchmarks(registry);
+  RegisterGetBufferedRegionBenchmarks(registry);
+  RegisterGetPixelVsIteratorBenchmarks(registry);
+  RegisterImageRegionDifferenceVsVectorBenchmarks(registry);
+  RegisterIteratorWithIndexBenchmarks(registry);
+  RegisterNeighborhoodIteratorBenchmarks(registry);
+  RegisterPatchDistanceBenchmarks(registry);
+  RegisterPatchMatchBenchmarks(registry);
+  RegisterShapedNeighborhoodIteratorBenchmarks(registry);
+  RegisterSquaredNormBenchmarks(registry);
+  RegisterTwoIteratorsVsOneIteratorAndGetPixelBenchmarks(registry);
+  RegisterVectorImageVsImageCovariantVectorBenchmarks(registry);
+}
+
+/** If 'argument' is "<prefix><value>", store <value> in 'value' and return true. */
+static bool ParseOption(const std::string& argument, const std::string& prefix, std::string& value)
+{
+  if(argument.compare(0, prefix.size(), prefix) != 0)
+  {
+    return false;
+  }
+  value = argument.substr(prefix.size());
+  return true;
+}
+
+/** Parses a comma separated list of positive numbers. Fails on anything else in an item, e.g. "64abc", "-1" or
+ *  a number that doesn't fit an unsigned int. */
+static bool ParseNumberList(const std::string& value, std::vector<unsigned int>& numbers)
+{
+  numbers.clear();
+
+  std::stringstream stream(value);
+  std::string item;
+  while(std::getline(stream, item, ','))
+  {
+    // strtoul() would skip leading white space and accept a sign, negating the number
+    if(item.empty() || item[0] < '0' || item[0] > '9')
+    {
+      return false;
+    }
+
+    char* end = NULL;
+    errno = 0;
+    const unsigned long number = std::strtoul(item.c_str(), &end, 10);
+    if(*end != '\0' || errno == ERANGE || number == 0 || number > UINT_MAX)
+    {
+      return false;
+    }
+    numbers.push_back(static_cast<unsigned int>(number));
+  }
+  return !numbers.empty();
+}
+
+static void PrintStatistics(const BenchmarkState& state)
+{
+  BenchmarkStatistics statistics = state.GetStatistics();
+
+  // Per iteration, in nanoseconds
+  const double scale = 1e9;
+
+  std::cout << "  Repetitions: " << statistics.NumberOfSamples
+            << "  Iterations/repetition: " << state.GetIterationsPerRepetition()
+            << "  Checksum: " << state.GetChecksum() << std::endl;
+
+  std::cout << std::fixed << std::setprecision(2)
+            << "  ns/iteration  Min: " << statistics.Minimum * scale
+            << "  Median: " << statistics.Median * scale
+            << "  MAD: " << statistics.MedianAbsoluteDeviation * scale
+            << "  P5: " << statistics.Percentile5 * scale
+            << "  P25: " << statistics.Percentile25 * scale
+            << "  P75: " << statistics.Percentile75 * scale
+            << "  P95: " << statistics.Percentile95 * scale
+            << "  Max: " << statistics.Maximum * scale << std::endl;
+  std::cout.unsetf(std::ios_base::floatfield);
+  std::cout << std::setprecision(6);
+
+  if(state.GetItemsPerIteration() > 0 && statistics.Median > 0)
+  {
+    std::cout << "  Items/second: " << state.GetItemsPerIteration() / statistics.Median;
+    if(state.GetBytesPerIteration() > 0)
+    {
+      std::cout << "  GB/second: " << state.GetBytesPerIteration() / statistics.Median / 1e9;
+    }
+    std::cout << std::endl;
+  }
+
+  std::map<std::string, double> counters = state.GetPerformanceCounters();
+  if(!counters.empty())
+  {
+    std::cout << "  Per iteration";
+    for(std::map<std::string, double>::const_iterator iterator = counters.begin(); iterator != counters.end(); ++iterator)
+    {
+      std::cout << "  " << iterator->first << ": " << iterator->second;
+    }
+    std::cout << std::endl;
+  }
+
+  std::map<std::string, double> allocationCounters = state.GetAllocationCounters();
+  if(!allocationCounters.empty())
+  {
+    std::cout << "  Allocations/iteration: " << allocationCounters["allocations"]
+              << "  Allocated bytes/iteration: " << allocationCounters["allocated_bytes"];
+    if(allocationCounters.count("peak_live_bytes") > 0)
+    {
+      std::cout << "  Peak live bytes: " << allocationCounters["peak_live_bytes"];
+    }
+    std::cout << std::endl;
+  }
+
+  const std::map<std::string, double>& caseCounters = state.GetCounters();
+  if(!caseCounters.empty())
+  {
+    std::cout << "  Counters";
+    for(std::map<std::string, double>::const_iterator iterator = caseCounters.begin();
+        iterator != caseCounters.end(); ++iterator)
+    {
+      std::cout << "  " << iterator->first << ": " << iterator->second;
+    }
+    std::cout << std::endl;
+  }
+}
+
+/** One line per result, so pixel types, dimensions and image sizes can be compared at a glance. */
+static void PrintSummary(const BenchmarkReport& report)
+{
+  size_t keyWidth = 4;
+  for(size_t i = 0; i < report.Results.size(); ++i)
+  {
+    keyWidth = std::max(keyWidth, report.Results[i].GetKey().size());
+  }
+
+  std::cout << std::endl << std::left << std::setw(keyWidth) << "Case" << std::right
+            << std::setw(16) << "Median ns/iter" << std::setw(16) << "Items/second" << std::setw(12) << "GB/second"
+            << std::endl;
+
+  for(size_t i = 0; i < report.Results.size(); ++i)
+  {
+    const BenchmarkResult& result = report.Results[i];
+    std::cout << std::left << std::setw(keyWidth) << result.GetKey() << std::right
+              << std::fixed << std::setprecision(2) << std::setw(16) << result.Statistics.Median * 1e9;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout << std::setprecision(4) << std::setw(16) << result.GetItemsPerSecond()
+              << std::setw(12) << result.GetBytesPerSecond() / 1e9 << std::endl;
+  }
+  std::cout << std::setprecision(6);
+}
+
+/** For every multi-threaded case run with several thread counts: the speedup of each run relative to the run
+ *  with the fewest threads, and the parallel efficiency (speedup per thread, relative to that run). */
+static void PrintScaling(const BenchmarkReport& report)
+{
+  // Results grouped by their key without the number of threads, in the order they were run
+  std::vector<std::string> groupKeys;
+  std::map<std::string, std::vector<const BenchmarkResult*> > groups;
+  for(size_t i = 0; i < report.Results.size(); ++i)
+  {
+    BenchmarkResult result = report.Results[i];
+    if(result.Parameters.erase("Threads") == 0)
+    {
+      continue;
+    }
+    const std::string groupKey = result.GetKey();
+    if(groups.count(groupKey) == 0)
+    {
+      groupKeys.push_back(groupKey);
+    }
+    groups[groupKey].push_back(&report.Results[i]);
+  }
+
+  std::cout << std::endl << "Scaling" << std::endl;
+  for(size_t groupId = 0; groupId < groupKeys.size(); ++groupId)
+  {
+    const std::vector<const BenchmarkResult*>& group = groups[groupKeys[groupId]];
+
+    const BenchmarkResult* base = group[0];
+    for(size_t i = 1; i < group.size(); ++i)
+    {
+      if(std::atoi(group[i]->Parameters.find("Threads")->second.c_str()) <
+         std::atoi(base->Parameters.find("Threads")->second.c_str()))
+      {
+        base = group[i];
+      }
+    }
+    const double baseThreads = std::atof(base->Parameters.find("Threads")->second.c_str());
+
+    std::cout << groupKeys[groupId] << std::endl;
+    for(size_t i = 0; i < group.size(); ++i)
+    {
+      const double threads = std::atof(group[i]->Parameters.find("Threads")->second.c_str());
+      const double speedup = group[i]->Statistics.Median > 0 ? base->Statistics.Median / group[i]->Statistics.Median : 0;
+      std::cout << std::fixed << std::setprecision(2)
+                << "  Threads: " << std::setw(4) << static_cast<unsigned int>(threads)
+                << "  Median ns/iter: " << std::setw(14) << group[i]->Statistics.Median * 1e9
+                << "  Speedup: " << std::setw(6) << speedup
+                << "  Efficiency: " << std::setw(6) << speedup * baseThreads / threads << std::endl;
+      std::cout.unsetf(std::ios_base::floatfield);
+    }
+  }
+  std::cout << std::setprecision(6);
+}
+
+static bool ReadReport(const std::string& fileName, BenchmarkReport& report)
+{
+  std::ifstream file(fileName.c_str());
+  if(!file)
+  {
+    std::cerr << "Could not open " << fileName << std::endl;
+    return false;
+  }
+
+  try
+  {
+    report = ReadJSONReport(file);
+  }
+  catch(std::exception& e)
+  {
+    std::cerr << fileName << ": " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+template <typename TWriter>
+static bool WriteReport(const std::string& fileName, const BenchmarkReport& report, TWriter writer)
+{
+  std::ofstream file(fileName.c_str());
+  if(!file)
+  {
+    std::cerr << "Could not write " << fileName << std::endl;
+    return false;
+  }
+  writer(file, report);
+  return true;
+}
+
+static int Compare(const BenchmarkReport& baseline, const BenchmarkReport& contender,
+                   const BenchmarkComparisonSettings& settings)
+{
+  std::vector<BenchmarkComparison> comparisons = CompareReports(baseline, contender, settings);
+  unsigned int numberOfRegressions = PrintComparison(std::cout, baseline, contender, comparisons);
+  return numberOfRegressions > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[])
+{
+  bool listOnly = false;
+  std::string filter = ".*";
+  BenchmarkSettings settings;
+  std::string jsonFileName;
+  std::string csvFileName;
+  std::string baselineFileName;
+  std::string contenderFileName;
+  BenchmarkComparisonSettings comparisonSettings;
+
+  // Empty: every case runs at its default image size
+  std::vector<unsigned int> imageSizes;
+
+  std::vector<unsigned int> threadCounts(1, ThreadPool::GetDefaultNumberOfThreads());
+
+  for(int i = 1; i < argc; ++i)
+  {
+    std::string argument = argv[i];
+    std::string value;
+    if(argument == "--list")
+    {
+      listOnly = true;
+    }
+    else if(ParseOption(argument, "--filter=", value))
+    {
+      filter = value;
+    }
+    else if(ParseOption(argument, "--warmup-time=", value))
+    {
+      settings.MinimumWarmupTime = std::atof(value.c_str());
+    }
+    else if(ParseOption(argument, "--min-time=", value))
+    {
+      settings.MinimumRepetitionTime = std::atof(value.c_str());
+    }
+    else if(ParseOption(argument, "--max-time=", value))
+    {
+      settings.MaximumMeasurementTime = std::atof(value.c_str());
+    }
+    else if(ParseOption(argument, "--iterations=", value))
+    {
+      settings.IterationsPerRepetition = std::strtoul(value.c_str(), NULL, 10);
+    }
+    else if(ParseOption(argument, "--repetitions=", value))
+    {
+      settings.NumberOfRepetitions = std::strtoul(value.c_str(), NULL, 10);
+    }
+    else if(ParseOption(argument, "--json=", value))
+    {
+      jsonFileName = value;
+    }
+    else if(ParseOption(argument, "--csv=", value))
+    {
+      csvFileName = value;
+    }
+    else if(ParseOption(argument, "--image-sizes=", value))
+    {
+      if(!ParseNumberList(value, imageSizes))
+      {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+    else if(argument == "--sweep")
+    {
+      imageSizes.clear();
+      for(unsigned int imageSize = 32; imageSize <= 8192; imageSize *= 2)
+      {
+        imageSizes.push_back(imageSize);
+      }
+    }
+    else if(ParseOption(argument, "--threads=", value))
+    {
+      if(!ParseNumberList(value, threadCounts))
+      {
+        PrintUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+    else if(argument == "--scaling")
+    {
+      threadCounts.clear();
+      const unsigned int maximumNumberOfThreads = ThreadPool::GetDefaultNumberOfThreads();
+      for(unsigned int numberOfThreads = 1; numberOfThreads < maximumNumberOfThreads; numberOfThreads *= 2)
+      {
+        threadCounts.push_back(numberOfThreads);
+      }
+      threadCounts.push_back(maximumNumberOfThreads);
+    }
+    else if(argument == "--perf-counters")
+    {
+      settings.CollectPerformanceCounters = true;
+    }
+    else if(argument == "--no-allocation-counters")
+    {
+      settings.CollectAllocationCounters = false;
+    }
+    else if(ParseOption(argument, "--baseline=", value))
+    {
+      baselineFileName = value;
+    }
+    else if(ParseOption(argument, "--contender=", value))
+    {
+      contenderFileName = value;
+    }
+    else if(ParseOption(argument, "--regression-threshold=", value))
+    {
+      comparisonSettings.RegressionThreshold = std::atof(value.c_str());
+    }
+    else if(ParseOption(argument, "--significance=", value))
+    {
+      comparisonSettings.SignificanceLevel = std::atof(value.c_str());
+    }
+    else
+    {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  BenchmarkReport baseline;
+  if(!baselineFileName.empty() && !ReadReport(baselineFileName, baseline))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if(!contenderFileName.empty())
+  {
+    BenchmarkReport contender;
+    if(baselineFileName.empty() || !ReadReport(contenderFileName, contender))
+    {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    return Compare(baseline, contender, comparisonSettings);
+  }
+
+  BenchmarkRegistry registry;
+  RegisterAllBenchmarks(registry);
+
+  std::vector<BenchmarkCase> cases;
+  try
+  {
+    cases = registry.GetMatchingCases(filter);
+  }
+  catch(std::regex_error&)
+  {
+    std::cerr << "Invalid filter expression: " << filter << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if(listOnly)
+  {
+    for(size_t i = 0; i < cases.size(); ++i)
+    {
+      std::cout << cases[i].Name;
+      if(cases[i].DefaultImageSize > 0)
+      {
+        std::cout << " (image size " << cases[i].DefaultImageSize << ")";
+      }
+      if(cases[i].IsMultiThreaded)
+      {
+        std::cout << " (multi-threaded)";
+      }
+      std::cout << std::endl;
+    }
+    return EXIT_SUCCESS;
+  }
+
+  if(settings.CollectPerformanceCounters)
+  {
+    PerformanceCounters counters;
+    if(!counters.IsAvailable())
+    {
+      std::cerr << "Warning: not collecting performance counters: " << counters.GetErrorMessage() << std::endl;
+      settings.CollectPerformanceCounters = false;
+    }
+  }
+
+  BenchmarkReport report;
+  report.BuildInformation = GetBenchmarkBuildInformation();
+
+  if(!imageSizes.empty() && !report.BuildInformation.CacheSizes.empty())
+  {
+    std::cout << "Caches: " << report.BuildInformation.CacheSizes << std::endl;
+  }
+
+  for(size_t i = 0; i < cases.size(); ++i)
+  {
+    std::vector<unsigned int> caseImageSizes(1, cases[i].DefaultImageSize);
+    if(cases[i].DefaultImageSize > 0 && !imageSizes.empty())
+    {
+      caseImageSizes = imageSizes;
+    }
+
+    std::vector<unsigned int> caseThreadCounts(1, 0);
+    if(cases[i].IsMultiThreaded)
+    {
+      caseThreadCounts = threadCounts;
+    }
+
+    for(size_t sizeId = 0; sizeId < caseImageSizes.size(); ++sizeId)
+    {
+      for(size_t threadCountId = 0; threadCountId < caseThreadCounts.size(); ++threadCountId)
+      {
+        BenchmarkSettings caseSettings = settings;
+        caseSettings.ImageSize = caseImageSizes[sizeId];
+        caseSettings.NumberOfThreads = caseThreadCounts[threadCountId];
+        // The counters only see the calling thread, not the pool threads doing most of the work
+        caseSettings.CollectPerformanceCounters = settings.CollectPerformanceCounters && !cases[i].IsMultiThreaded;
+
+        BenchmarkState state(cases[i].Name, caseSettings);
+        std::cout << BenchmarkResult(state).GetKey() << std::endl;
+
+        cases[i].Function(state);
+
+        PrintStatistics(state);
+        report.Results.push_back(BenchmarkResult(state));
+      }
+    }
+  }
+
+  if(report.Results.size() > 1)
+  {
+    PrintSummary(report);
+  }
+  if(threadCounts.size() > 1)
+  {
+    PrintScaling(report);
+  }
+
+  if(!jsonFileName.empty() && !WriteReport(jsonFileName, report, WriteJSONReport))
+  {
+    return EXIT_FAILURE;
+  }
+  if(!csvFileName.empty() && !WriteReport(csvFileName, report, WriteCSVReport))
+  {
+    return EXIT_FAILURE;
+  }
+
+  if(!baselineFileName.empty())
+  {
+    std::cout << std::endl;
+    return Compare(baseline, report, comparisonSettings);
+  }
+
+  return EXIT_SUCCESS;
+}
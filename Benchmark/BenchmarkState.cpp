@@ -0,0 +1,283 @@
+#include "BenchmarkState.h"
+
+#include "AllocationCounters.h"
+#include "DoNotOptimize.h"
+#include "PerformanceCounters.h"
+
+// STL
+#include <algorithm>
+
+#if !defined(__GNUC__) && !defined(__clang__)
+namespace DoNotOptimizeInternal
+{
+void UseCharPointer(char const volatile*)
+{
+}
+}
+#endif
+
+BenchmarkSettings::BenchmarkSettings() :
+  MinimumWarmupTime(0.1), MinimumRepetitionTime(0.01), MaximumMeasurementTime(2.0),
+  MinimumNumberOfRepetitions(10), MaximumNumberOfRepetitions(1000),
+  TargetRelativeMedianAbsoluteDeviation(0.01),
+  IterationsPerRepetition(0), NumberOfRepetitions(0),
+  CollectPerformanceCounters(false), CollectAllocationCounters(true), ImageSize(0), NumberOfThreads(0)
+{
+}
+
+BenchmarkState::BenchmarkState(const std::string& name, const BenchmarkSettings& settings) :
+  m_Name(name), m_Settings(settings), m_Phase(NotStarted),
+  m_IterationsPerRepetition(1), m_IterationsRemainingInRepetition(0),
+  m_WarmupTime(0), m_MeasurementTime(0), m_Checksum(0),
+  m_ItemsPerIteration(0), m_BytesPerIteration(0)
+{
+  if(m_Settings.IterationsPerRepetition > 0)
+  {
+    m_IterationsPerRepetition = m_Settings.IterationsPerRepetition;
+  }
+
+  if(m_Settings.CollectPerformanceCounters)
+  {
+    m_PerformanceCounters.reset(new PerformanceCounters);
+  }
+  if(m_Settings.CollectAllocationCounters)
+  {
+    m_AllocationCounters.reset(new AllocationCounters);
+  }
+
+  if(m_Settings.ImageSize > 0)
+  {
+    SetParameter("ImageSize", m_Settings.ImageSize);
+  }
+  if(m_Settings.NumberOfThreads > 0)
+  {
+    SetParameter("Threads", m_Settings.NumberOfThreads);
+  }
+}
+
+BenchmarkState::~BenchmarkState()
+{
+}
+
+void BenchmarkState::StartRepetition()
+{
+  // The current call to KeepRunning() accounts for the first iteration
+  m_IterationsRemainingInRepetition = m_IterationsPerRepetition - 1;
+  if(m_Phase == Measuring && m_PerformanceCounters)
+  {
+    m_PerformanceCounters->Start();
+  }
+  if(m_Phase == Measuring && m_AllocationCounters)
+  {
+    m_AllocationCounters->Start();
+  }
+  ClobberMemory();
+  m_RepetitionStart = std::chrono::steady_clock::now();
+}
+
+bool BenchmarkState::FinishRepetition()
+{
+  std::chrono::steady_clock::time_point repetitionEnd = std::chrono::steady_clock::now();
+  ClobberMemory();
+  if(m_Phase == Measuring && m_AllocationCounters)
+  {
+    m_AllocationCounters->Stop();
+  }
+  if(m_Phase == Measuring && m_PerformanceCounters)
+  {
+    m_PerformanceCounters->Stop();
+  }
+
+  double repetitionTime = std::chrono::duration<double>(repetitionEnd - m_RepetitionStart).count();
+
+  switch(m_Phase)
+  {
+    case NotStarted:
+      m_Phase = WarmingUp;
+      break;
+
+    case WarmingUp:
+    {
+      m_WarmupTime += repetitionTime;
+
+      bool calibrated = m_Settings.IterationsPerRepetition > 0 ||
+                        repetitionTime >= m_Settings.MinimumRepetitionTime;
+      if(!calibrated)
+      {
+        // Aim a little past the minimum so we don't just barely miss it again
+        double multiplier = 2.0;
+        if(repetitionTime > 0)
+        {
+          multiplier = std::min(10.0, std::max(2.0, 1.4 * m_Settings.MinimumRepetitionTime / repetitionTime));
+        }
+        m_IterationsPerRepetition = static_cast<unsigned long>(m_IterationsPerRepetition * multiplier);
+      }
+      else if(m_WarmupTime >= m_Settings.MinimumWarmupTime)
+      {
+        m_Phase = Measuring;
+      }
+      break;
+    }
+
+    case Measuring:
+      m_Samples.push_back(repetitionTime / m_IterationsPerRepetition);
+      m_MeasurementTime += repetitionTime;
+      if(IsMeasurementComplete())
+      {
+        m_Phase = Finished;
+        return false;
+      }
+      break;
+
+    case Finished:
+      return false;
+  }
+
+  StartRepetition();
+  return true;
+}
+
+bool BenchmarkState::IsMeasurementComplete() const
+{
+  if(m_Settings.NumberOfRepetitions > 0)
+  {
+    return m_Samples.size() >= m_Settings.NumberOfRepetitions;
+  }
+
+  if(m_Samples.size() < m_Settings.MinimumNumberOfRepetitions)
+  {
+    return false;
+  }
+
+  if(m_Samples.size() >= m_Settings.MaximumNumberOfRepetitions ||
+     m_MeasurementTime >= m_Settings.MaximumMeasurementTime)
+  {
+    return true;
+  }
+
+  BenchmarkStatistics statistics = ComputeStatistics(m_Samples);
+  return statistics.MedianAbsoluteDeviation <= m_Settings.TargetRelativeMedianAbsoluteDeviation * statistics.Median;
+}
+
+const std::string& BenchmarkState::GetName() const
+{
+  return m_Name;
+}
+
+unsigned int BenchmarkState::GetImageSize() const
+{
+  return m_Settings.ImageSize;
+}
+
+unsigned int BenchmarkState::GetNumberOfThreads() const
+{
+  return m_Settings.NumberOfThreads;
+}
+
+unsigned long BenchmarkState::GetIterationsPerRepetition() const
+{
+  return m_IterationsPerRepetition;
+}
+
+const std::vector<double>& BenchmarkState::GetSamples() const
+{
+  return m_Samples;
+}
+
+BenchmarkStatistics BenchmarkState::GetStatistics() const
+{
+  return ComputeStatistics(m_Samples);
+}
+
+void BenchmarkState::SetChecksum(const double checksum)
+{
+  m_Checksum = checksum;
+}
+
+double BenchmarkState::GetChecksum() const
+{
+  return m_Checksum;
+}
+
+const std::map<std::string, std::string>& BenchmarkState::GetParameters() const
+{
+  return m_Parameters;
+}
+
+void BenchmarkState::SetItemsPerIteration(const double itemsPerIteration)
+{
+  m_ItemsPerIteration = itemsPerIteration;
+}
+
+double BenchmarkState::GetItemsPerIteration() const
+{
+  return m_ItemsPerIteration;
+}
+
+void BenchmarkState::SetBytesPerIteration(const double bytesPerIteration)
+{
+  m_BytesPerIteration = bytesPerIteration;
+}
+
+double BenchmarkState::GetBytesPerIteration() const
+{
+  return m_BytesPerIteration;
+}
+
+void BenchmarkState::SetCounter(const std::string& name, const double value)
+{
+  m_Counters[name] = value;
+}
+
+const std::map<std::string, double>& BenchmarkState::GetCounters() const
+{
+  return m_Counters;
+}
+
+std::map<std::string, double> BenchmarkState::GetPerformanceCounters() const
+{
+  std::map<std::string, double> counters;
+
+  double numberOfIterations = static_cast<double>(m_Samples.size()) * m_IterationsPerRepetition;
+  if(!m_PerformanceCounters || numberOfIterations == 0)
+  {
+    return counters;
+  }
+
+  for(unsigned int event = 0; event < PerformanceCounters::NumberOfEvents; ++event)
+  {
+    PerformanceCounters::Event performanceEvent = static_cast<PerformanceCounters::Event>(event);
+    if(m_PerformanceCounters->IsAvailable(performanceEvent))
+    {
+      counters[PerformanceCounters::GetEventName(performanceEvent)] =
+        m_PerformanceCounters->GetCount(performanceEvent) / numberOfIterations;
+    }
+  }
+
+  if(counters.count("cycles") > 0 && counters.count("instructions") > 0 && counters["cycles"] > 0)
+  {
+    counters["ipc"] = counters["instructions"] / counters["cycles"];
+  }
+
+  return counters;
+}
+
+std::map<std::string, double> BenchmarkState::GetAllocationCounters() const
+{
+  std::map<std::string, double> counters;
+
+  double numberOfIterations = static_cast<double>(m_Samples.size()) * m_IterationsPerRepetition;
+  if(!m_AllocationCounters || numberOfIterations == 0)
+  {
+    return counters;
+  }
+
+  counters["allocations"] = m_AllocationCounters->GetNumberOfAllocations() / numberOfIterations;
+  counters["allocated_bytes"] = m_AllocationCounters->GetAllocatedBytes() / numberOfIterations;
+  if(AllocationCounters::IsPeakLiveBytesAvailable())
+  {
+    counters["peak_live_bytes"] = m_AllocationCounters->GetPeakLiveBytes();
+  }
+
+  return counters;
+}
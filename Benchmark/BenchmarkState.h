@@ -0,0 +1,202 @@
+/**
+ * The timing harness that drives a benchmark case's measured loop.
+ *
+ * A case sets up its data, then runs its measured body as
+ *
+ *   while(state.KeepRunning())
+ *   {
+ *     total = Kernel(image.GetPointer());
+ *     DoNotOptimize(total);
+ *   }
+ *   state.SetChecksum(total);
+ *
+ * KeepRunning() runs the body in batches ("repetitions") and times each batch as a whole,
+ * so the clock is read once per batch rather than once per iteration:
+ *
+ * 1) Warmup: batches are run untimed for at least MinimumWarmupTime, doubling (or more) the
+ *    number of iterations per batch until one batch takes at least MinimumRepetitionTime.
+ * 2) Measurement: batches of that size are timed until there are at least MinimumNumberOfRepetitions
+ *    samples, and then until either the relative MAD of the samples drops below
+ *    TargetRelativeMedianAbsoluteDeviation, MaximumMeasurementTime is spent or MaximumNumberOfRepetitions
+ *    samples are taken.
+ *
+ * Each sample is the time per iteration of one batch.
+ *
+ * A case can also describe what it measured, for the result files:
+ *
+ *   state.SetParameter("Radius", radius);
+ *   state.SetItemsPerIteration(image->GetLargestPossibleRegion().GetNumberOfPixels());
+ *   state.SetBytesPerIteration(numberOfPixels * sizeof(PixelType));
+ *
+ * and report values it computed about its output, e.g. how close an approximate search came to the exact one:
+ *
+ *   state.SetCounter("exact_match_fraction", quality.ExactMatchFraction);
+ *
+ * Cases registered with a default image size build their image with AllocateImage(image, GetImageSize())
+ * (see BenchmarkImageTypes.h), i.e. with as many pixels as a GetImageSize() x GetImageSize() image, so the
+ * runner can sweep the working set from L1-resident to DRAM-resident; the size is recorded as the
+ * "ImageSize" parameter.
+ *
+ * Multi-threaded cases (see BenchmarkRegistry::AddMultiThreaded()) run their kernels on GetNumberOfThreads()
+ * threads, recorded as the "Threads" parameter.
+ *
+ * With CollectPerformanceCounters, hardware counters (see PerformanceCounters.h) are read around
+ * every measured repetition, i.e. only while the measured loop runs. The runner leaves them out for
+ * multi-threaded cases: they would only count the calling thread.
+ *
+ * With CollectAllocationCounters (the default), heap allocations (see AllocationCounters.h) are counted the
+ * same way, so a case that should not allocate in its measured loop reports 0 allocations per iteration.
+ */
+
+#ifndef BenchmarkState_h
+#define BenchmarkState_h
+
+#include "BenchmarkStatistics.h"
+
+// STL
+#include <chrono>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct BenchmarkSettings
+{
+  BenchmarkSettings();
+
+  /** Seconds */
+  double MinimumWarmupTime;
+  double MinimumRepetitionTime;
+  double MaximumMeasurementTime;
+
+  unsigned int MinimumNumberOfRepetitions;
+  unsigned int MaximumNumberOfRepetitions;
+
+  /** The measurement stops early once MAD/median is below this. */
+  double TargetRelativeMedianAbsoluteDeviation;
+
+  /** If non-zero, every repetition runs exactly this many iterations instead of calibrating. */
+  unsigned long IterationsPerRepetition;
+
+  /** If non-zero, exactly this many repetitions are measured. */
+  unsigned int NumberOfRepetitions;
+
+  bool CollectPerformanceCounters;
+  bool CollectAllocationCounters;
+
+  /** The image extent for cases that take one (set by the runner per case and size); 0 otherwise. */
+  unsigned int ImageSize;
+
+  /** The number of threads for multi-threaded cases (set by the runner per case and thread count); 0 otherwise. */
+  unsigned int NumberOfThreads;
+};
+
+class AllocationCounters;
+class PerformanceCounters;
+
+class BenchmarkState
+{
+public:
+  BenchmarkState(const std::string& name, const BenchmarkSettings& settings);
+  ~BenchmarkState();
+
+  /** Returns true while the case should run its measured body again. */
+  inline bool KeepRunning()
+  {
+    if(m_IterationsRemainingInRepetition > 0)
+    {
+      --m_IterationsRemainingInRepetition;
+      return true;
+    }
+    return FinishRepetition();
+  }
+
+  const std::string& GetName() const;
+
+  /** The side of the square with as many pixels as the image the case should traverse. */
+  unsigned int GetImageSize() const;
+
+  unsigned int GetNumberOfThreads() const;
+
+  /** The number of iterations in each measured repetition. */
+  unsigned long GetIterationsPerRepetition() const;
+
+  /** Time per iteration of each measured repetition, in seconds. */
+  const std::vector<double>& GetSamples() const;
+
+  BenchmarkStatistics GetStatistics() const;
+
+  void SetChecksum(const double checksum);
+  double GetChecksum() const;
+
+  template <typename T>
+  void SetParameter(const std::string& name, const T& value)
+  {
+    std::stringstream stream;
+    stream << value;
+    m_Parameters[name] = stream.str();
+  }
+  const std::map<std::string, std::string>& GetParameters() const;
+
+  /** The number of "items" (usually pixels) one iteration processes, for reporting throughput. */
+  void SetItemsPerIteration(const double itemsPerIteration);
+  double GetItemsPerIteration() const;
+
+  /** The number of bytes one iteration reads and writes, for reporting bandwidth. */
+  void SetBytesPerIteration(const double bytesPerIteration);
+  double GetBytesPerIteration() const;
+
+  /** A value the case computed about its output (not per iteration), recorded with the performance counters. */
+  void SetCounter(const std::string& name, const double value);
+  const std::map<std::string, double>& GetCounters() const;
+
+  /** Hardware event counts per iteration, by event name (plus "ipc"), for the events that were available. */
+  std::map<std::string, double> GetPerformanceCounters() const;
+
+  /** "allocations" and "allocated_bytes" per iteration and "peak_live_bytes" (see AllocationCounters.h),
+   *  if they were collected. */
+  std::map<std::string, double> GetAllocationCounters() const;
+
+private:
+  // Not copyable: owns the performance and allocation counters
+  BenchmarkState(const BenchmarkState&);
+  void operator=(const BenchmarkState&);
+
+  enum Phase
+  {
+    NotStarted,
+    WarmingUp,
+    Measuring,
+    Finished
+  };
+
+  bool FinishRepetition();
+  void StartRepetition();
+  bool IsMeasurementComplete() const;
+
+  std::string m_Name;
+  BenchmarkSettings m_Settings;
+  Phase m_Phase;
+
+  unsigned long m_IterationsPerRepetition;
+  unsigned long m_IterationsRemainingInRepetition;
+
+  std::chrono::steady_clock::time_point m_RepetitionStart;
+  double m_WarmupTime;
+  double m_MeasurementTime;
+
+  std::vector<double> m_Samples;
+  double m_Checksum;
+
+  std::map<std::string, std::string> m_Parameters;
+  double m_ItemsPerIteration;
+  double m_BytesPerIteration;
+
+  std::map<std::string, double> m_Counters;
+
+  std::unique_ptr<PerformanceCounters> m_PerformanceCounters;
+  std::unique_ptr<AllocationCounters> m_AllocationCounters;
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "BenchmarkStatistics.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+BenchmarkStatistics::BenchmarkStatistics() :
+  NumberOfSamples(0), Minimum(0), Maximum(0), Mean(0), Median(0), MedianAbsoluteDeviation(0),
+  Percentile5(0), Percentile25(0), Percentile75(0), Percentile95(0)
+{
+}
+
+double ComputePercentile(const std::vector<double>& sortedSamples, const double p)
+{
+  if(sortedSamples.empty())
+  {
+    return 0;
+  }
+
+  double rank = (p / 100.0) * (sortedSamples.size() - 1);
+  size_t lower = static_cast<size_t>(std::floor(rank));
+  size_t upper = static_cast<size_t>(std::ceil(rank));
+  double fraction = rank - lower;
+
+  return sortedSamples[lower] + fraction * (sortedSamples[upper] - sortedSamples[lower]);
+}
+
+BenchmarkStatistics ComputeStatistics(const std::vector<double>& samples)
+{
+  BenchmarkStatistics statistics;
+  if(samples.empty())
+  {
+    return statistics;
+  }
+
+  std::vector<double> sortedSamples(samples);
+  std::sort(sortedSamples.begin(), sortedSamples.end());
+
+  statistics.NumberOfSamples = sortedSamples.size();
+  statistics.Minimum = sortedSamples.front();
+  statistics.Maximum = sortedSamples.back();
+
+  double sum = 0;
+  for(size_t i = 0; i < sortedSamples.size(); ++i)
+  {
+    sum += sortedSamples[i];
+  }
+  statistics.Mean = sum / sortedSamples.size();
+
+  statistics.Median = ComputePercentile(sortedSamples, 50);
+  statistics.Percentile5 = ComputePercentile(sortedSamples, 5);
+  statistics.Percentile25 = ComputePercentile(sortedSamples, 25);
+  statistics.Percentile75 = ComputePercentile(sortedSamples, 75);
+  statistics.Percentile95 = ComputePercentile(sortedSamples, 95);
+
+  std::vector<double> absoluteDeviations(sortedSamples.size());
+  for(size_t i = 0; i < sortedSamples.size(); ++i)
+  {
+    absoluteDeviations[i] = std::fabs(sortedSamples[i] - statistics.Median);
+  }
+  std::sort(absoluteDeviations.begin(), absoluteDeviations.end());
+  statistics.MedianAbsoluteDeviation = ComputePercentile(absoluteDeviations, 50);
+
+  return statistics;
+}
@@ -0,0 +1,40 @@
+/**
+ * Robust summary statistics of a set of timing samples.
+ *
+ * Timing noise is one sided (interrupts, frequency changes and cache pollution only ever make
+ * a repetition slower), so the median and the median absolute deviation (MAD) are reported
+ * alongside the minimum instead of relying on the mean and standard deviation.
+ */
+
+#ifndef BenchmarkStatistics_h
+#define BenchmarkStatistics_h
+
+// STL
+#include <vector>
+
+struct BenchmarkStatistics
+{
+  BenchmarkStatistics();
+
+  unsigned int NumberOfSamples;
+
+  double Minimum;
+  double Maximum;
+  double Mean;
+  double Median;
+
+  /** median(|x_i - median(x)|) */
+  double MedianAbsoluteDeviation;
+
+  double Percentile5;
+  double Percentile25;
+  double Percentile75;
+  double Percentile95;
+};
+
+BenchmarkStatistics ComputeStatistics(const std::vector<double>& samples);
+
+/** The p-th (0 <= p <= 100) percentile of 'sortedSamples', linearly interpolated between closest ranks. */
+double ComputePercentile(const std::vector<double>& sortedSamples, const double p);
+
+#endif
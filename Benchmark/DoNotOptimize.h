@@ -0,0 +1,75 @@
+/**
+ * Optimization barriers for measured loops.
+ *
+ * DoNotOptimize(value) forces 'value' to be computed (and, if it lives in memory, written),
+ * so the work that produced it can't be removed as dead code.
+ * ClobberMemory() forces all pending writes to memory to happen, and prevents the compiler from
+ * assuming memory is unchanged across the barrier, so stores and reloads can't be hoisted out of the loop.
+ *
+ * Unlike accumulating into a "counter to make sure the loop isn't optimized away",
+ * neither adds any arithmetic to the measured loop.
+ */
+
+#ifndef DoNotOptimize_h
+#define DoNotOptimize_h
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+
+// STL
+#include <type_traits>
+
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** Values that fit in a register may stay in one. The register alternative comes first for GCC too: GCC 12
+ *  can pick the memory alternative for a value just loaded from memory without storing the value there. */
+template <typename T>
+inline typename std::enable_if<std::is_trivially_copyable<T>::value && (sizeof(T) <= sizeof(T*))>::type
+DoNotOptimize(T& value)
+{
+  asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+/** Larger values must be in memory: GCC may otherwise pick the register alternative for e.g. a 12 byte
+ *  RGBPixel and corrupt it. */
+template <typename T>
+inline typename std::enable_if<!std::is_trivially_copyable<T>::value || (sizeof(T) > sizeof(T*))>::type
+DoNotOptimize(T& value)
+{
+  asm volatile("" : "+m"(value) : : "memory");
+}
+
+inline void ClobberMemory()
+{
+  asm volatile("" : : : "memory");
+}
+
+#else
+
+namespace DoNotOptimizeInternal
+{
+void UseCharPointer(char const volatile*);
+}
+
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+  DoNotOptimizeInternal::UseCharPointer(&reinterpret_cast<char const volatile&>(value));
+  _ReadWriteBarrier();
+}
+
+inline void ClobberMemory()
+{
+  _ReadWriteBarrier();
+}
+
+#endif
+
+#endif
@@ -0,0 +1,125 @@
+/**
+ * Visit an image region as a sequence of contiguous rows (along dimension 0) instead of one pixel at a time.
+ *
+ * ForEachRowSpan(image, region, function) calls
+ *
+ *   function(const InternalPixelType* row, size_t length, const IndexType& rowStart)
+ *
+ * for every row of 'region' in row-major order: 'row' points to the first pixel of the row in the buffer,
+ * 'length' is the number of pixels in the row and 'rowStart' is the index of the first one. The kernel gets
+ * a plain loop over 'row', which the compiler can vectorize, where an ImageRegionConstIterator would check
+ * for the end of the row at every pixel:
+ *
+ *   ForEachRowSpan(image, region, [&sum](const float* row, const size_t length, const itk::Index<2>&)
+ *     {
+ *     for(size_t i = 0; i < length; ++i)
+ *       {
+ *       sum += row[i];
+ *       }
+ *     });
+ *
+ * AnyRowSpan() is the same with an early exit: 'function' returns true to stop, and AnyRowSpan() returns
+ * whether it did.
+ *
+ * For a VectorImage, 'row' points to the first component of the first pixel and a pixel is
+ * GetNumberOfComponentsPerPixel() consecutive components; 'length' is still in pixels.
+ */
+
+#ifndef ImageRowSpans_h
+#define ImageRowSpans_h
+
+// ITK
+#include "itkImage.h"
+#include "itkVectorImage.h"
+
+// STL
+#include <cstddef>
+#include <stdexcept>
+
+/** The number of buffer elements per pixel. */
+template <typename TImage>
+struct RowSpanPixelTraits
+{
+  static std::size_t GetNumberOfComponents(const TImage* const)
+  {
+    return 1;
+  }
+};
+
+template <typename TValue, unsigned int VImageDimension>
+struct RowSpanPixelTraits<itk::VectorImage<TValue, VImageDimension> >
+{
+  static std::size_t GetNumberOfComponents(const itk::VectorImage<TValue, VImageDimension>* const image)
+  {
+    return image->GetNumberOfComponentsPerPixel();
+  }
+};
+
+/** 'region' must be inside the buffered region. */
+template <typename TImage, typename TFunction>
+bool AnyRowSpan(const TImage* const image, const typename TImage::RegionType& region, TFunction function)
+{
+  typedef typename TImage::InternalPixelType InternalPixelType;
+
+  if(region.GetNumberOfPixels() == 0)
+  {
+    return false;
+  }
+  if(!image->GetBufferedRegion().IsInside(region))
+  {
+    throw std::runtime_error("Cannot visit the rows of a region outside of the buffered region!");
+  }
+
+  const InternalPixelType* const buffer = image->GetBufferPointer();
+  const std::size_t numberOfComponents = RowSpanPixelTraits<TImage>::GetNumberOfComponents(image);
+  const std::size_t length = region.GetSize()[0];
+
+  typename TImage::IndexType rowStart = region.GetIndex();
+  while(true)
+  {
+    if(function(buffer + image->ComputeOffset(rowStart) * numberOfComponents, length,
+                static_cast<const typename TImage::IndexType&>(rowStart)))
+    {
+      return true;
+    }
+
+    // Next row in row-major order
+    unsigned int dimension = 1;
+    for(; dimension < TImage::ImageDimension; ++dimension)
+    {
+      if(++rowStart[dimension] < region.GetIndex()[dimension] + static_cast<itk::IndexValueType>(region.GetSize()[dimension]))
+      {
+        break;
+      }
+      rowStart[dimension] = region.GetIndex()[dimension];
+    }
+    if(dimension == TImage::ImageDimension)
+    {
+      return false;
+    }
+  }
+}
+
+/** Adapts a function returning void to AnyRowSpan(). */
+template <typename TFunction>
+struct VisitEveryRowSpan
+{
+  TFunction& Function;
+
+  template <typename TPixel, typename TIndex>
+  bool operator()(const TPixel* const row, const std::size_t length, const TIndex& rowStart) const
+  {
+    Function(row, length, rowStart);
+    return false;
+  }
+};
+
+/** 'region' must be inside the buffered region. */
+template <typename TImage, typename TFunction>
+void ForEachRowSpan(const TImage* const image, const typename TImage::RegionType& region, TFunction function)
+{
+  VisitEveryRowSpan<TFunction> visitor = {function};
+  AnyRowSpan(image, region, visitor);
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include "PerformanceCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// STL
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+static int OpenEvent(const PerformanceCounters::Event event)
+{
+  perf_event_attr attributes;
+  std::memset(&attributes, 0, sizeof(attributes));
+  attributes.size = sizeof(attributes);
+  attributes.disabled = 0;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+  switch(event)
+  {
+    case PerformanceCounters::Cycles:
+      attributes.type = PERF_TYPE_HARDWARE;
+      attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case PerformanceCounters::Instructions:
+      attributes.type = PERF_TYPE_HARDWARE;
+      attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case PerformanceCounters::L1DataCacheMisses:
+      attributes.type = PERF_TYPE_HW_CACHE;
+      attributes.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    case PerformanceCounters::LastLevelCacheMisses:
+      attributes.type = PERF_TYPE_HW_CACHE;
+      attributes.config = PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    case PerformanceCounters::BranchMisses:
+      attributes.type = PERF_TYPE_HARDWARE;
+      attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+    case PerformanceCounters::DataTLBMisses:
+      attributes.type = PERF_TYPE_HW_CACHE;
+      attributes.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      break;
+    default:
+      return -1;
+  }
+
+  // This thread, any CPU, no group
+  return static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+#endif
+
+PerformanceCounters::PerformanceCounters()
+{
+  for(unsigned int event = 0; event < NumberOfEvents; ++event)
+  {
+    m_FileDescriptors[event] = -1;
+    m_Counts[event] = 0;
+    std::memset(&m_StartReadings[event], 0, sizeof(Reading));
+  }
+
+#if defined(__linux__)
+  int lastError = 0;
+  for(unsigned int event = 0; event < NumberOfEvents; ++event)
+  {
+    m_FileDescriptors[event] = OpenEvent(static_cast<Event>(event));
+    if(m_FileDescriptors[event] < 0)
+    {
+      lastError = errno;
+    }
+  }
+
+  if(!IsAvailable())
+  {
+    m_ErrorMessage = std::string("perf_event_open failed: ") + std::strerror(lastError);
+    if(lastError == EACCES || lastError == EPERM)
+    {
+      m_ErrorMessage += " (see /proc/sys/kernel/perf_event_paranoid)";
+    }
+  }
+#else
+  m_ErrorMessage = "Performance counters are only supported on Linux";
+#endif
+}
+
+PerformanceCounters::~PerformanceCounters()
+{
+#if defined(__linux__)
+  for(unsigned int event = 0; event < NumberOfEvents; ++event)
+  {
+    if(m_FileDescriptors[event] >= 0)
+    {
+      close(m_FileDescriptors[event]);
+    }
+  }
+#endif
+}
+
+bool PerformanceCounters::IsAvailable() const
+{
+  for(unsigned int event = 0; event < NumberOfEvents; ++event)
+  {
+    if(IsAvailable(static_cast<Event>(event)))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool PerformanceCounters::IsAvailable(const Event event) const
+{
+  return m_FileDescriptors[event] >= 0;
+}
+
+const char* PerformanceCounters::GetEventName(const Event event)
+{
+  switch(event)
+  {
+    case Cycles: return "cycles";
+    case Instructions: return "instructions";
+    case L1DataCacheMisses: return "l1d_misses";
+    case LastLevelCacheMisses: return "llc_misses";
+    case BranchMisses: return "branch_misses";
+    case DataTLBMisses: return "dtlb_misses";
+    default: return "";
+  }
+}
+
+bool PerformanceCounters::Read(const Event event, Reading& reading) const
+{
+#if defined(__linux__)
+  if(m_FileDescriptors[event] < 0)
+  {
+    return false;
+  }
+  unsigned long long values[3];
+  if(read(m_FileDescriptors[event], values, sizeof(values)) != static_cast<ssize_t>(sizeof(values)))
+  {
+    return false;
+  }
+  reading.Value = values[0];
+  reading.TimeEnabled = values[1];
+  reading.TimeRunning = values[2];
+  return true;
+#else
+  (void)event;
+  (void)reading;
+  return false;
+#endif
+}
+
+void PerformanceCounters::Start()
+{
+  for(unsigned int event = 0; event < NumberOfEvents; ++event)
+  {
+    Read(static_cast<Event>(event), m_StartReadings[event]);
+  }
+}
+
+void PerformanceCounters::Stop()
+{
+  // Read everything first, so the bookkeeping below isn't counted
+  Reading stopReadings[NumberOfEvents];
+  bool valid[NumberOfEvents];
+  for(unsigned int event = 0; event < NumberOfEvents; ++event)
+  {
+    valid[event] = Read(static_cast<Event>(event), stopReadings[event]);
+  }
+
+  for(unsigned int event = 0; event < NumberOfEvents; ++event)
+  {
+    if(!valid[event])
+    {
+      continue;
+    }
+
+    double value = stopReadings[event].Value - m_StartReadings[event].Value;
+    double timeEnabled = stopReadings[event].TimeEnabled - m_StartReadings[event].TimeEnabled;
+    double timeRunning = stopReadings[event].TimeRunning - m_StartReadings[event].TimeRunning;
+
+    // The counter was multiplexed with others: extrapolate to the whole interval
+    if(timeRunning > 0 && timeRunning < timeEnabled)
+    {
+      value *= timeEnabled / timeRunning;
+    }
+    m_Counts[event] += value;
+  }
+}
+
+double PerformanceCounters::GetCount(const Event event) const
+{
+  return m_Counts[event];
+}
+
+const std::string& PerformanceCounters::GetErrorMessage() const
+{
+  return m_ErrorMessage;
+}
@@ -0,0 +1,74 @@
+/**
+ * Hardware performance counters for the measured region of a benchmark case (Linux perf_event_open).
+ *
+ * Each event is opened on its own rather than as a group, so a CPU that can't count all of them at once
+ * multiplexes them instead of failing; counts are scaled by time-enabled / time-running to compensate.
+ * Only user space of the calling thread is counted, which works with the default perf_event_paranoid of 2;
+ * threads it starts, like those of a ThreadPool, are not.
+ *
+ * Events that can't be opened (no PMU in a VM, perf_event_paranoid too high, not Linux) are simply
+ * unavailable: IsAvailable(event) is false and the event is left out of the results.
+ */
+
+#ifndef PerformanceCounters_h
+#define PerformanceCounters_h
+
+// STL
+#include <string>
+
+class PerformanceCounters
+{
+public:
+  enum Event
+  {
+    Cycles,
+    Instructions,
+    L1DataCacheMisses,
+    LastLevelCacheMisses,
+    BranchMisses,
+    DataTLBMisses,
+    NumberOfEvents
+  };
+
+  /** Opens every event that is available. */
+  PerformanceCounters();
+  ~PerformanceCounters();
+
+  /** True if at least one event could be opened. */
+  bool IsAvailable() const;
+  bool IsAvailable(const Event event) const;
+
+  /** The name used in the reports, e.g. "llc_misses". */
+  static const char* GetEventName(const Event event);
+
+  /** Counting happens between Start() and Stop(); successive Start()/Stop() pairs accumulate. */
+  void Start();
+  void Stop();
+
+  /** The accumulated count of 'event', scaled for multiplexing. */
+  double GetCount(const Event event) const;
+
+  /** Why no event could be opened, if none could. */
+  const std::string& GetErrorMessage() const;
+
+private:
+  // Not copyable: owns file descriptors
+  PerformanceCounters(const PerformanceCounters&);
+  void operator=(const PerformanceCounters&);
+
+  struct Reading
+  {
+    unsigned long long Value;
+    unsigned long long TimeEnabled;
+    unsigned long long TimeRunning;
+  };
+
+  bool Read(const Event event, Reading& reading) const;
+
+  int m_FileDescriptors[NumberOfEvents];
+  Reading m_StartReadings[NumberOfEvents];
+  double m_Counts[NumberOfEvents];
+  std::string m_ErrorMessage;
+};
+
+#endif
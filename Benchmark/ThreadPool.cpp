@@ -0,0 +1,98 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(const unsigned int numberOfThreads) :
+  m_Generation(0), m_Stopping(false), m_Function(NULL), m_NumberOfChunks(0), m_NextChunk(0),
+  m_NumberOfBusyWorkers(0)
+{
+  for(unsigned int i = 1; i < numberOfThreads; ++i)
+  {
+    m_Workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stopping = true;
+  }
+  m_WorkAvailable.notify_all();
+
+  for(size_t i = 0; i < m_Workers.size(); ++i)
+  {
+    m_Workers[i].join();
+  }
+}
+
+unsigned int ThreadPool::GetNumberOfThreads() const
+{
+  return static_cast<unsigned int>(m_Workers.size()) + 1;
+}
+
+unsigned int ThreadPool::GetDefaultNumberOfThreads()
+{
+  unsigned int numberOfThreads = std::thread::hardware_concurrency();
+  return numberOfThreads > 0 ? numberOfThreads : 1;
+}
+
+void ThreadPool::ParallelFor(const std::size_t numberOfChunks, const std::function<void(std::size_t)>& function)
+{
+  if(m_Workers.empty() || numberOfChunks <= 1)
+  {
+    for(std::size_t chunkId = 0; chunkId < numberOfChunks; ++chunkId)
+    {
+      function(chunkId);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Function = &function;
+    m_NumberOfChunks = numberOfChunks;
+    m_NextChunk = 0;
+    m_NumberOfBusyWorkers = static_cast<unsigned int>(m_Workers.size());
+    ++m_Generation;
+  }
+  m_WorkAvailable.notify_all();
+
+  RunChunks();
+
+  // The chunks are all taken; wait until the workers have finished theirs
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  m_WorkDone.wait(lock, [this] { return m_NumberOfBusyWorkers == 0; });
+  m_Function = NULL;
+}
+
+void ThreadPool::RunChunks()
+{
+  for(std::size_t chunkId = m_NextChunk++; chunkId < m_NumberOfChunks; chunkId = m_NextChunk++)
+  {
+    (*m_Function)(chunkId);
+  }
+}
+
+void ThreadPool::WorkerLoop()
+{
+  unsigned long lastGeneration = 0;
+  while(true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_Mutex);
+      m_WorkAvailable.wait(lock, [&] { return m_Stopping || m_Generation != lastGeneration; });
+      if(m_Stopping)
+      {
+        return;
+      }
+      lastGeneration = m_Generation;
+    }
+
+    RunChunks();
+
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      --m_NumberOfBusyWorkers;
+    }
+    m_WorkDone.notify_one();
+  }
+}
@@ -0,0 +1,68 @@
+/**
+ * A minimal pool of worker threads for the multi-threaded kernels.
+ *
+ * ParallelFor(numberOfChunks, function) calls function(chunkId) once for every chunk, on the workers
+ * and the calling thread, handing chunks out dynamically, and returns when all of them are done.
+ *
+ * Kernels make their results independent of the number of threads by splitting the work into a fixed
+ * number of chunks (not one per thread), writing each chunk's partial result into its own slot, and
+ * reducing the slots in chunk order afterwards:
+ *
+ *   std::vector<double> partialSums(numberOfChunks);
+ *   pool.ParallelFor(numberOfChunks, [&](size_t chunkId) { partialSums[chunkId] = SumChunk(chunkId); });
+ *   double sum = std::accumulate(partialSums.begin(), partialSums.end(), 0.0);
+ *
+ * The workers are started once, so dispatching work costs a wake up rather than a thread creation.
+ */
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+// STL
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+public:
+  /** Starts numberOfThreads - 1 workers; the thread calling ParallelFor() is the last one. */
+  explicit ThreadPool(const unsigned int numberOfThreads);
+  ~ThreadPool();
+
+  unsigned int GetNumberOfThreads() const;
+
+  void ParallelFor(const std::size_t numberOfChunks, const std::function<void(std::size_t)>& function);
+
+  /** The number of hardware threads, or 1 if unknown. */
+  static unsigned int GetDefaultNumberOfThreads();
+
+private:
+  // Not copyable: owns threads
+  ThreadPool(const ThreadPool&);
+  void operator=(const ThreadPool&);
+
+  void WorkerLoop();
+  void RunChunks();
+
+  std::vector<std::thread> m_Workers;
+
+  std::mutex m_Mutex;
+  std::condition_variable m_WorkAvailable;
+  std::condition_variable m_WorkDone;
+
+  /** Incremented for every ParallelFor(), so workers can tell new work from a spurious wake up. */
+  unsigned long m_Generation;
+  bool m_Stopping;
+
+  const std::function<void(std::size_t)>* m_Function;
+  std::size_t m_NumberOfChunks;
+  std::atomic<std::size_t> m_NextChunk;
+  unsigned int m_NumberOfBusyWorkers;
+};
+
+#endif
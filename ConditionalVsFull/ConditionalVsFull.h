@@ -0,0 +1,149 @@
+/**
+ * Demo: Iterate over an image looking for a pixel with a particular value.
+ *       Do this by using a conditional and returning immediately if the value is found,
+ *       and compare to not using a conditional in the loop and simply &= each value test.
+ *
+ * Conclusion:
+ * Using a conditional in the loop is marginally slower (< 10%) if the entire image is searched,
+ * but allows for the possibility of a much earlier return, so it should be favored.
+ *
+ * HasValueChunked() gets both: it compares a chunk of pixels of the buffer at a time without a branch,
+ * which the compiler vectorizes, and only checks for a match after each chunk. HasValueParallel() splits
+ * the buffer into blocks scanned on a ThreadPool, and every thread stops after its current chunk once any
+ * thread has found the value. HasValueRowSpans() applies HasValueChunked() to each row of a region
+ * (see ImageRowSpans.h), for regions that are not the whole buffer.
+ */
+
+#ifndef ConditionalVsFull_h
+#define ConditionalVsFull_h
+
+#include "ImageRowSpans.h"
+#include "ThreadPool.h"
+
+// ITK
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+
+// STL
+#include <algorithm>
+#include <atomic>
+
+namespace ConditionalVsFull
+{
+
+template <typename TImage>
+bool HasValueConditional(const TImage* const image, const typename TImage::PixelType& value)
+{
+  itk::ImageRegionConstIterator<TImage> iterator(image, image->GetLargestPossibleRegion());
+
+  while(!iterator.IsAtEnd())
+  {
+    if(iterator.Get() == value)
+    {
+      return true;
+    }
+
+    ++iterator;
+  }
+  return false;
+}
+
+template <typename TImage>
+bool HasValue(const TImage* const image, const typename TImage::PixelType& value)
+{
+  itk::ImageRegionConstIterator<TImage> iterator(image, image->GetLargestPossibleRegion());
+
+  bool hasValue = true;
+
+  while(!iterator.IsAtEnd())
+  {
+    hasValue &= (iterator.Get() == value);
+
+    ++iterator;
+  }
+  return hasValue;
+}
+
+/** Bytes of pixels HasValueChunked() compares between two checks for a match: a few cache lines, so the
+ *  branch is rare but a match doesn't read much past it. */
+const size_t hasValueChunkSize = 256;
+
+/** True if any of the 'numberOfPixels' pixels at 'buffer' is 'value'. */
+template <typename TPixel>
+bool HasValueChunked(const TPixel* const buffer, const size_t numberOfPixels, const TPixel& value)
+{
+  const size_t pixelsPerChunk = std::max<size_t>(hasValueChunkSize / sizeof(TPixel), 1);
+
+  for(size_t chunkStart = 0; chunkStart < numberOfPixels; chunkStart += pixelsPerChunk)
+  {
+    const size_t chunkEnd = std::min(chunkStart + pixelsPerChunk, numberOfPixels);
+
+    // No branch in the loop, so it vectorizes (a bool accumulator gets short-circuited into a branch)
+    unsigned int matches = 0;
+    for(size_t i = chunkStart; i < chunkEnd; ++i)
+    {
+      matches |= static_cast<unsigned int>(buffer[i] == value);
+    }
+    if(matches)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename TImage>
+bool HasValueChunked(const TImage* const image, const typename TImage::PixelType& value)
+{
+  return HasValueChunked(image->GetBufferPointer(), image->GetBufferedRegion().GetNumberOfPixels(), value);
+}
+
+template <typename TImage>
+bool HasValueRowSpans(const TImage* const image, const typename TImage::PixelType& value)
+{
+  return AnyRowSpan(image, image->GetLargestPossibleRegion(),
+                    [&value](const typename TImage::PixelType* row, const size_t length, const typename TImage::IndexType&)
+  {
+    return HasValueChunked(row, length, value);
+  });
+}
+
+template <typename TImage>
+bool HasValueParallel(const TImage* const image, const typename TImage::PixelType& value, ThreadPool& pool)
+{
+  typedef typename TImage::PixelType PixelType;
+
+  const PixelType* const buffer = image->GetBufferPointer();
+  const size_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+
+  // Several blocks per thread to balance the load, each of many chunks so a block is worth handing out
+  const size_t pixelsPerChunk = std::max<size_t>(hasValueChunkSize / sizeof(PixelType), 1);
+  const size_t numberOfChunks = (numberOfPixels + pixelsPerChunk - 1) / pixelsPerChunk;
+  const size_t numberOfBlocks = std::min<size_t>(numberOfChunks, 8 * pool.GetNumberOfThreads());
+  if(numberOfBlocks <= 1)
+  {
+    return HasValueChunked(buffer, numberOfPixels, value);
+  }
+
+  std::atomic<bool> found(false);
+  pool.ParallelFor(numberOfBlocks, [&](const size_t blockId)
+  {
+    const size_t blockStart = blockId * numberOfChunks / numberOfBlocks * pixelsPerChunk;
+    const size_t blockEnd = std::min((blockId + 1) * numberOfChunks / numberOfBlocks * pixelsPerChunk, numberOfPixels);
+
+    // A chunk at a time, so the other threads' result is checked as often as this thread's
+    for(size_t chunkStart = blockStart; chunkStart < blockEnd && !found.load(std::memory_order_relaxed);
+        chunkStart += pixelsPerChunk)
+    {
+      if(HasValueChunked(buffer + chunkStart, std::min(pixelsPerChunk, blockEnd - chunkStart), value))
+      {
+        found.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+  return found.load();
+}
+
+} // end namespace ConditionalVsFull
+
+#endif
@@ -0,0 +1,326 @@
+/**
+ * A side structure that answers "does value v occur in region R of the image" without scanning every pixel,
+ * for images that are queried far more often than they change (e.g. label images).
+ *
+ * The buffered region is split into tiles of TileSize pixels along every dimension (smaller at the far edges).
+ * For every tile the summary stores the minimum and maximum pixel, and for 8 bit integer pixels a
+ * 256 bit presence bitmap. A query only visits the tiles that overlap the region, skips those whose
+ * summary rules the value out, answers from the bitmap alone for 8 bit tiles entirely inside the region,
+ * and scans (with HasValueChunked()) the part of the remaining candidate tiles that is inside the region.
+ *
+ * The summary is only valid for the image contents it was built from. Queries call Update(), which rebuilds
+ * it when the image's MTime is newer than the last build. Writing pixels through the buffer does not bump
+ * the MTime, so after changing pixels call image->Modified(), or, if the changes are confined to a region,
+ * UpdateRegion(region) to rebuild only the tiles it overlaps.
+ *
+ * Only scalar pixel types are supported (the summary compares pixels with <).
+ */
+
+#ifndef TileSummary_h
+#define TileSummary_h
+
+#include "ConditionalVsFull.h"
+#include "ImageRowSpans.h"
+
+// ITK
+#include "itkImage.h"
+
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace ConditionalVsFull
+{
+
+template <typename TImage>
+class TileSummary
+{
+public:
+  typedef typename TImage::PixelType PixelType;
+  typedef typename TImage::RegionType RegionType;
+  typedef typename TImage::IndexType IndexType;
+  typedef typename TImage::SizeType SizeType;
+
+  static const unsigned int ImageDimension = TImage::ImageDimension;
+
+  /** Pixels along every dimension of a tile. */
+  static const unsigned int TileSize = ImageDimension == 2 ? 32 : 8;
+
+  /** 8 bit integer pixels have a presence bitmap per tile, so a tile can be ruled in or out exactly. */
+  static const bool HasPresenceBitmap = std::numeric_limits<PixelType>::is_integer && sizeof(PixelType) == 1;
+
+  TileSummary() :
+    m_Image(NULL), m_BuildTime(0), m_NumberOfTiles(0), m_NumberOfTilesScanned(0)
+  {
+  }
+
+  /** The summary is built by the first query or Update(). */
+  void SetImage(const TImage* const image)
+  {
+    m_Image = image;
+    m_BuildTime = 0;
+  }
+
+  /** Rebuilds the whole summary if the image has been modified since the last build. */
+  void Update()
+  {
+    if(!m_Image)
+    {
+      throw std::runtime_error("TileSummary has no image!");
+    }
+    if(m_BuildTime != 0 && m_Image->GetMTime() <= m_BuildTime &&
+       m_Region == m_Image->GetBufferedRegion())
+    {
+      return;
+    }
+
+    m_Region = m_Image->GetBufferedRegion();
+    m_NumberOfTiles = 1;
+    for(unsigned int dimension = 0; dimension < ImageDimension; ++dimension)
+    {
+      m_TileGridSize[dimension] = (m_Region.GetSize()[dimension] + TileSize - 1) / TileSize;
+      m_NumberOfTiles *= m_TileGridSize[dimension];
+    }
+
+    m_Minimum.resize(m_NumberOfTiles);
+    m_Maximum.resize(m_NumberOfTiles);
+    m_Presence.resize(HasPresenceBitmap ? m_NumberOfTiles * WordsPerBitmap : 0);
+
+    if(m_NumberOfTiles > 0)
+    {
+      BuildTiles(GetTileGridRegion());
+    }
+    m_BuildTime = m_Image->GetMTime();
+  }
+
+  /** Rebuilds only the tiles that overlap 'modifiedRegion' (cropped to the buffered region), which must
+   *  contain every pixel changed since the last build. */
+  void UpdateRegion(const RegionType& modifiedRegion)
+  {
+    if(m_BuildTime == 0 || m_Region != m_Image->GetBufferedRegion())
+    {
+      Update();
+      return;
+    }
+
+    RegionType tiles;
+    if(GetOverlappingTiles(modifiedRegion, tiles))
+    {
+      BuildTiles(tiles);
+    }
+    m_BuildTime = m_Image->GetMTime();
+  }
+
+  bool HasValue(const PixelType& value)
+  {
+    Update();
+    return HasValue(value, m_Region);
+  }
+
+  /** True if 'value' occurs in 'region', cropped to the buffered region. */
+  bool HasValue(const PixelType& value, const RegionType& region)
+  {
+    Update();
+    m_NumberOfTilesScanned = 0;
+
+    RegionType croppedRegion = region;
+    RegionType tiles;
+    if(!croppedRegion.Crop(m_Region) || !GetOverlappingTiles(croppedRegion, tiles))
+    {
+      return false;
+    }
+
+    IndexType tileIndex = tiles.GetIndex();
+    do
+    {
+      const size_t tileId = GetTileId(tileIndex);
+      if(value < m_Minimum[tileId] || m_Maximum[tileId] < value)
+      {
+        continue;
+      }
+
+      const RegionType tileRegion = GetTileRegion(tileIndex);
+      const bool tileInsideRegion = croppedRegion.IsInside(tileRegion);
+      if(HasPresenceBitmap)
+      {
+        if(!IsPresent(tileId, value))
+        {
+          continue;
+        }
+        if(tileInsideRegion)
+        {
+          return true;
+        }
+      }
+      else if(tileInsideRegion && !(m_Minimum[tileId] < value) && !(value < m_Maximum[tileId]))
+      {
+        return true; // The whole tile is 'value'
+      }
+
+      RegionType scanRegion = tileRegion;
+      scanRegion.Crop(croppedRegion);
+      ++m_NumberOfTilesScanned;
+      if(AnyRowSpan(m_Image, scanRegion, [&value](const PixelType* row, const size_t length, const IndexType&)
+      {
+        return HasValueChunked(row, length, value);
+      }))
+      {
+        return true;
+      }
+    } while(NextTile(tiles, tileIndex));
+
+    return false;
+  }
+
+  size_t GetNumberOfTiles() const
+  {
+    return m_NumberOfTiles;
+  }
+
+  /** The number of tiles whose pixels the last query had to read. */
+  size_t GetNumberOfTilesScanned() const
+  {
+    return m_NumberOfTilesScanned;
+  }
+
+private:
+  // Not copyable: a copy would share the image but not rebuild with it
+  TileSummary(const TileSummary&);
+  void operator=(const TileSummary&);
+
+  static const size_t WordsPerBitmap = 256 / 64;
+
+  /** Steps 'tileIndex' to the next tile of 'tiles' in row-major order; false after the last one. */
+  static bool NextTile(const RegionType& tiles, IndexType& tileIndex)
+  {
+    for(unsigned int dimension = 0; dimension < ImageDimension; ++dimension)
+    {
+      ++tileIndex[dimension];
+      if(tileIndex[dimension] < tiles.GetIndex()[dimension] + static_cast<itk::IndexValueType>(tiles.GetSize()[dimension]))
+      {
+        return true;
+      }
+      tileIndex[dimension] = tiles.GetIndex()[dimension];
+    }
+    return false;
+  }
+
+  RegionType GetTileGridRegion() const
+  {
+    IndexType corner;
+    corner.Fill(0);
+    return RegionType(corner, m_TileGridSize);
+  }
+
+  /** The tiles overlapping 'region' cropped to the buffered region; false if they don't overlap. */
+  bool GetOverlappingTiles(const RegionType& region, RegionType& tiles) const
+  {
+    RegionType croppedRegion = region;
+    if(!croppedRegion.Crop(m_Region))
+    {
+      return false;
+    }
+
+    IndexType firstTile;
+    SizeType numberOfTiles;
+    for(unsigned int dimension = 0; dimension < ImageDimension; ++dimension)
+    {
+      const itk::IndexValueType start = croppedRegion.GetIndex()[dimension] - m_Region.GetIndex()[dimension];
+      const itk::IndexValueType end = start + croppedRegion.GetSize()[dimension] - 1;
+      firstTile[dimension] = start / TileSize;
+      numberOfTiles[dimension] = end / TileSize - firstTile[dimension] + 1;
+    }
+    tiles = RegionType(firstTile, numberOfTiles);
+    return true;
+  }
+
+  size_t GetTileId(const IndexType& tileIndex) const
+  {
+    size_t tileId = 0;
+    for(int dimension = ImageDimension - 1; dimension >= 0; --dimension)
+    {
+      tileId = tileId * m_TileGridSize[dimension] + tileIndex[dimension];
+    }
+    return tileId;
+  }
+
+  RegionType GetTileRegion(const IndexType& tileIndex) const
+  {
+    IndexType corner;
+    SizeType size;
+    for(unsigned int dimension = 0; dimension < ImageDimension; ++dimension)
+    {
+      const itk::SizeValueType start = tileIndex[dimension] * TileSize;
+      corner[dimension] = m_Region.GetIndex()[dimension] + start;
+      size[dimension] = std::min<itk::SizeValueType>(TileSize, m_Region.GetSize()[dimension] - start);
+    }
+    return RegionType(corner, size);
+  }
+
+  bool IsPresent(const size_t tileId, const PixelType& value) const
+  {
+    const unsigned int code = static_cast<unsigned char>(value);
+    return (m_Presence[tileId * WordsPerBitmap + code / 64] >> (code % 64)) & 1;
+  }
+
+  void BuildTiles(const RegionType& tiles)
+  {
+    IndexType tileIndex = tiles.GetIndex();
+    do
+    {
+      const size_t tileId = GetTileId(tileIndex);
+      const RegionType tileRegion = GetTileRegion(tileIndex);
+
+      PixelType minimum = m_Image->GetPixel(tileRegion.GetIndex());
+      PixelType maximum = minimum;
+      std::uint64_t* const presence = HasPresenceBitmap ? &m_Presence[tileId * WordsPerBitmap] : NULL;
+      if(HasPresenceBitmap)
+      {
+        std::fill(presence, presence + WordsPerBitmap, 0);
+      }
+
+      ForEachRowSpan(m_Image, tileRegion,
+                     [&minimum, &maximum, presence](const PixelType* row, const size_t length, const IndexType&)
+      {
+        for(size_t i = 0; i < length; ++i)
+        {
+          minimum = std::min(minimum, row[i]);
+          maximum = std::max(maximum, row[i]);
+          if(HasPresenceBitmap)
+          {
+            const unsigned int code = static_cast<unsigned char>(row[i]);
+            presence[code / 64] |= std::uint64_t(1) << (code % 64);
+          }
+        }
+      });
+
+      m_Minimum[tileId] = minimum;
+      m_Maximum[tileId] = maximum;
+    } while(NextTile(tiles, tileIndex));
+  }
+
+  const TImage* m_Image;
+
+  /** The image's MTime when the summary was last brought up to date; 0 if never built. */
+  itk::ModifiedTimeType m_BuildTime;
+
+  /** The buffered region the summary was built for. */
+  RegionType m_Region;
+
+  SizeType m_TileGridSize;
+  size_t m_NumberOfTiles;
+
+  /** Per tile, in row-major order of the tile grid */
+  std::vector<PixelType> m_Minimum;
+  std::vector<PixelType> m_Maximum;
+  std::vector<std::uint64_t> m_Presence;
+
+  size_t m_NumberOfTilesScanned;
+};
+
+} // end namespace ConditionalVsFull
+
+#endif
@@ -0,0 +1,37 @@
+/**
+ * Demo: Compare getting the size of an image from GetLargestPossibleRegion(), GetBufferedRegion()
+ *       and a region saved ahead of time.
+ *
+ * Conclusion:
+ * All of these functions seem to take about the same time.
+ */
+
+#ifndef GetBufferedRegion_h
+#define GetBufferedRegion_h
+
+// ITK
+#include "itkImage.h"
+
+namespace GetBufferedRegion
+{
+
+template <typename TImage>
+unsigned int GetLargestPossibleRegion(const TImage* const image)
+{
+  return image->GetLargestPossibleRegion().GetSize()[0];
+}
+
+template <typename TImage>
+unsigned int GetBufferedRegion(const TImage* const image)
+{
+  return image->GetBufferedRegion().GetSize()[0];
+}
+
+inline unsigned int SavedRegion(const itk::ImageRegion<2>& region)
+{
+  return region.GetSize()[0];
+}
+
+} // end namespace GetBufferedRegion
+
+#endif
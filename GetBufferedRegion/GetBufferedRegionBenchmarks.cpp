@@ -0,0 +1,71 @@
+#include "GetBufferedRegion.h"
+
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+namespace
+{
+
+typedef itk::Image<unsigned char, 2> ImageType;
+
+itk::ImageRegion<2> CreateImage(ImageType* const image)
+{
+  itk::Index<2> corner={{0,0}};
+  itk::Size<2> size = {{10,10}};
+  itk::ImageRegion<2> region(corner,size);
+  image->SetRegions(region);
+  image->Allocate();
+  return region;
+}
+
+void SavedRegionCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  itk::ImageRegion<2> region = CreateImage(image.GetPointer());
+
+  int counter = 0;
+  while(state.KeepRunning())
+  {
+    DoNotOptimize(region); // Otherwise the size is read once, outside of the loop
+    counter = GetBufferedRegion::SavedRegion(region);
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+void GetBufferedRegionCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image.GetPointer());
+
+  int counter = 0;
+  while(state.KeepRunning())
+  {
+    counter = GetBufferedRegion::GetBufferedRegion(image.GetPointer());
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+void GetLargestPossibleRegionCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image.GetPointer());
+
+  int counter = 0;
+  while(state.KeepRunning())
+  {
+    counter = GetBufferedRegion::GetLargestPossibleRegion(image.GetPointer());
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+} // end anonymous namespace
+
+void RegisterGetBufferedRegionBenchmarks(BenchmarkRegistry& registry)
+{
+  registry.Add("GetBufferedRegion/SavedRegion", SavedRegionCase); // 1e8 iterations took about 3 seconds in the original demo
+  registry.Add("GetBufferedRegion/GetBufferedRegion", GetBufferedRegionCase); // 1e8 iterations took about 3 seconds in the original demo
+  registry.Add("GetBufferedRegion/GetLargestPossibleRegion", GetLargestPossibleRegionCase); // 1e8 iterations took about 3 - 3.5 seconds in the original demo
+}
@@ -0,0 +1,102 @@
+/**
+ * Demo: Iterate over an image and do something with Get() at each pixel.
+ *       Compare this to calling GetPixel() at each index of the region, in the same (row-major) order.
+ *
+ *       RowSpans() visits the same pixels a row at a time (see ImageRowSpans.h), with a plain loop over each row.
+ *
+ *       PixelGather.h reads the pixels at a list of indices, comparing GetPixel() to precomputed buffer offsets.
+ *
+ * Conclusion:
+ * Using the iterator is about 3-4x faster.
+ */
+
+#ifndef GetPixelVsIterator_h
+#define GetPixelVsIterator_h
+
+#include "BenchmarkImageTypes.h"
+#include "ImageRowSpans.h"
+
+// ITK
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+
+namespace GetPixelVsIterator
+{
+
+template <typename TImage>
+typename BenchmarkPixelTraits<typename TImage::PixelType>::AccumulateType Iterator(const TImage* image)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  itk::ImageRegionConstIterator<TImage> imageIterator(image, image->GetLargestPossibleRegion());
+
+  typename PixelTraits::AccumulateType counter = PixelTraits::GetZero();
+  while(!imageIterator.IsAtEnd())
+  {
+    PixelTraits::Accumulate(counter, imageIterator.Get());
+
+    ++imageIterator;
+  }
+
+  return counter;
+}
+
+/** The indices are generated rather than read from a list of all of them, which would be
+ *  8 bytes per pixel per dimension and swamp the image itself in the cache for large images. */
+template <typename TImage>
+typename BenchmarkPixelTraits<typename TImage::PixelType>::AccumulateType GetPixel(const TImage* image)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  const typename TImage::RegionType region = image->GetLargestPossibleRegion();
+  const typename TImage::IndexType begin = region.GetIndex();
+  const typename TImage::IndexType end = region.GetUpperIndex();
+
+  typename PixelTraits::AccumulateType counter = PixelTraits::GetZero();
+  typename TImage::IndexType index = begin;
+  for(itk::SizeValueType pixelId = 0; pixelId < region.GetNumberOfPixels(); ++pixelId)
+  {
+    PixelTraits::Accumulate(counter, image->GetPixel(index));
+
+    // Next index in row-major order
+    for(unsigned int dimension = 0; dimension < TImage::ImageDimension; ++dimension)
+    {
+      if(++index[dimension] <= end[dimension])
+      {
+        break;
+      }
+      index[dimension] = begin[dimension];
+    }
+  }
+
+  return counter;
+}
+
+template <typename TImage>
+typename BenchmarkPixelTraits<typename TImage::PixelType>::AccumulateType RowSpans(const TImage* image)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename PixelTraits::AccumulateType counter = PixelTraits::GetZero();
+  ForEachRowSpan(image, image->GetLargestPossibleRegion(),
+                 [&counter](const typename TImage::PixelType* row, const size_t length, const typename TImage::IndexType&)
+  {
+    for(size_t i = 0; i < length; ++i)
+    {
+      PixelTraits::Accumulate(counter, row[i]);
+    }
+  });
+
+  return counter;
+}
+
+template <typename TImage>
+void CreateImage(TImage* const image, const unsigned int imageSize)
+{
+  AllocateImage(image, imageSize);
+  image->FillBuffer(BenchmarkPixelTraits<typename TImage::PixelType>::MakePixel(0));
+}
+
+} // end namespace GetPixelVsIterator
+
+#endif
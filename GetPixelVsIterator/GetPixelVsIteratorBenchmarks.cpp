@@ -0,0 +1,229 @@
+#include "GetPixelVsIterator.h"
+#include "PixelGather.h"
+
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+// STL
+#include <random>
+#include <vector>
+
+namespace
+{
+
+template <typename TImage>
+void IteratorCase(BenchmarkState& state)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  GetPixelVsIterator::CreateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * sizeof(typename TImage::PixelType));
+
+  typename PixelTraits::AccumulateType total = PixelTraits::GetZero();
+  while(state.KeepRunning())
+  {
+    total = GetPixelVsIterator::Iterator(image.GetPointer());
+    DoNotOptimize(total);
+  }
+  state.SetChecksum(PixelTraits::GetSum(total));
+}
+
+template <typename TImage>
+void GetPixelCase(BenchmarkState& state)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  GetPixelVsIterator::CreateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * sizeof(typename TImage::PixelType));
+
+  typename PixelTraits::AccumulateType total = PixelTraits::GetZero();
+  while(state.KeepRunning())
+  {
+    total = GetPixelVsIterator::GetPixel(image.GetPointer());
+    DoNotOptimize(total);
+  }
+  state.SetChecksum(PixelTraits::GetSum(total));
+}
+
+template <typename TImage>
+void RowSpansCase(BenchmarkState& state)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  GetPixelVsIterator::CreateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * sizeof(typename TImage::PixelType));
+
+  typename PixelTraits::AccumulateType total = PixelTraits::GetZero();
+  while(state.KeepRunning())
+  {
+    total = GetPixelVsIterator::RowSpans(image.GetPointer());
+    DoNotOptimize(total);
+  }
+  state.SetChecksum(PixelTraits::GetSum(total));
+}
+
+enum IndexPattern
+{
+  /** Every pixel, in buffer order */
+  Sequential,
+  /** Every pixel, with the first dimension slowest, so consecutive pixels are a row (or slice) apart */
+  Strided,
+  /** One pixel in 16, anywhere: sparse sample points */
+  Random
+};
+
+const char* GetIndexPatternName(const IndexPattern pattern)
+{
+  switch(pattern)
+  {
+    case Sequential:
+      return "Sequential";
+    case Strided:
+      return "Strided";
+    default:
+      return "Random";
+  }
+}
+
+template <typename TImage>
+std::vector<typename TImage::IndexType> MakeIndices(const TImage* const image, const IndexPattern pattern)
+{
+  const typename TImage::RegionType region = image->GetLargestPossibleRegion();
+  const itk::SizeValueType numberOfPixels = region.GetNumberOfPixels();
+
+  std::vector<typename TImage::IndexType> indices;
+  if(pattern == Sequential)
+  {
+    for(itk::SizeValueType offset = 0; offset < numberOfPixels; ++offset)
+    {
+      indices.push_back(image->ComputeIndex(offset));
+    }
+  }
+  else if(pattern == Strided)
+  {
+    const itk::SizeValueType rowLength = region.GetSize()[0];
+    for(itk::SizeValueType x = 0; x < rowLength; ++x)
+    {
+      for(itk::SizeValueType offset = x; offset < numberOfPixels; offset += rowLength)
+      {
+        indices.push_back(image->ComputeIndex(offset));
+      }
+    }
+  }
+  else
+  {
+    std::mt19937 generator(0);
+    std::uniform_int_distribution<itk::SizeValueType> offsetDistribution(0, numberOfPixels - 1);
+    for(itk::SizeValueType i = 0; i < numberOfPixels / 16; ++i)
+    {
+      indices.push_back(image->ComputeIndex(offsetDistribution(generator)));
+    }
+  }
+  return indices;
+}
+
+enum GatherVariant
+{
+  /** GetPixel() at every index */
+  GetPixelGather,
+  /** PixelGather in index order */
+  OffsetGather,
+  PrefetchGather,
+  SortedGather
+};
+
+template <typename TImage, IndexPattern TPattern, GatherVariant TVariant>
+void GatherCase(BenchmarkState& state)
+{
+  typedef typename TImage::PixelType PixelType;
+  typedef BenchmarkPixelTraits<PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  AllocateImage(image.GetPointer(), state.GetImageSize());
+  // Pixel values that differ, so a gather that reads the wrong pixels changes the checksum
+  for(itk::SizeValueType offset = 0; offset < image->GetBufferedRegion().GetNumberOfPixels(); ++offset)
+  {
+    image->GetBufferPointer()[offset] = PixelTraits::MakePixel(offset % 101);
+  }
+
+  const std::vector<typename TImage::IndexType> indices = MakeIndices(image.GetPointer(), TPattern);
+  state.SetItemsPerIteration(indices.size());
+  state.SetBytesPerIteration(indices.size() * sizeof(PixelType));
+
+  GetPixelVsIterator::PixelGather<TImage> gather;
+  gather.SetIndices(image.GetPointer(), indices,
+                    TVariant == SortedGather ? gather.SortOffsets : gather.IndexOrder);
+  gather.SetPrefetchDistance(TVariant == PrefetchGather ? 16 : 0);
+
+  std::vector<PixelType> values(indices.size());
+  while(state.KeepRunning())
+  {
+    if(TVariant == GetPixelGather)
+    {
+      GetPixelVsIterator::GetPixels(image.GetPointer(), indices, values.data());
+    }
+    else
+    {
+      gather.Gather(image.GetPointer(), values.data());
+    }
+    DoNotOptimize(values.data());
+    ClobberMemory();
+  }
+
+  // Weighted by position, so values gathered in the wrong order change it too
+  double checksum = 0;
+  for(size_t i = 0; i < values.size(); ++i)
+  {
+    typename PixelTraits::AccumulateType value = PixelTraits::GetZero();
+    PixelTraits::Accumulate(value, values[i]);
+    checksum += static_cast<double>(i % 7) * PixelTraits::GetSum(value);
+  }
+  state.SetChecksum(checksum);
+}
+
+template <typename TImage, IndexPattern TPattern>
+void RegisterGatherCases(BenchmarkRegistry& registry)
+{
+  const std::string prefix = std::string("GetPixelVsIterator/IndexList/") + GetIndexPatternName(TPattern) + "/";
+  const std::string imageTypeName = GetImageTypeName<TImage>();
+  registry.Add(prefix + "GetPixel/" + imageTypeName, GatherCase<TImage, TPattern, GetPixelGather>, 1000);
+  registry.Add(prefix + "Gather/" + imageTypeName, GatherCase<TImage, TPattern, OffsetGather>, 1000);
+  registry.Add(prefix + "GatherPrefetch/" + imageTypeName, GatherCase<TImage, TPattern, PrefetchGather>, 1000);
+  registry.Add(prefix + "GatherSorted/" + imageTypeName, GatherCase<TImage, TPattern, SortedGather>, 1000);
+}
+
+struct Registrar
+{
+  BenchmarkRegistry& Registry;
+
+  template <typename TImage>
+  void Register() const
+  {
+    const std::string imageTypeName = GetImageTypeName<TImage>();
+    Registry.Add("GetPixelVsIterator/Iterator/" + imageTypeName, IteratorCase<TImage>, 100);
+    Registry.Add("GetPixelVsIterator/GetPixel/" + imageTypeName, GetPixelCase<TImage>, 100);
+    Registry.Add("GetPixelVsIterator/RowSpans/" + imageTypeName, RowSpansCase<TImage>, 100);
+
+    RegisterGatherCases<TImage, Sequential>(Registry);
+    RegisterGatherCases<TImage, Strided>(Registry);
+    RegisterGatherCases<TImage, Random>(Registry);
+  }
+};
+
+} // end anonymous namespace
+
+void RegisterGetPixelVsIteratorBenchmarks(BenchmarkRegistry& registry)
+{
+  // For uint8/2D, 1e5 iterations took 1.4 (Iterator) and 5.9 (GetPixel) seconds in the original demo
+  Registrar registrar = {registry};
+  ForEachImageType(registrar);
+}
@@ -0,0 +1,194 @@
+/**
+ * Read the pixels at a list of indices (seed points, landmarks, contour pixels, ...) many times.
+ *
+ * GetPixel() turns every index into a buffer offset again on every read. PixelGather converts the list into
+ * linear buffer offsets once, in SetIndices(), and Gather() then only loads from the buffer:
+ * - optionally in increasing offset order (SortOffsets), so the loads walk the buffer forward and pixels
+ *   that share a cache line are read together; the values are still written in the order of the indices;
+ * - optionally prefetching the pixel PrefetchDistance loads ahead, so the cache misses of a scattered
+ *   list overlap instead of being paid one after the other.
+ *
+ * The offsets are only valid for images with the buffered region of the image they were computed for.
+ */
+
+#ifndef PixelGather_h
+#define PixelGather_h
+
+// ITK
+#include "itkImage.h"
+
+// STL
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <xmmintrin.h>
+#endif
+
+namespace GetPixelVsIterator
+{
+
+inline void PrefetchForRead(const void* const address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  __builtin_prefetch(address, 0, 3);
+#elif defined(_MSC_VER)
+  _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+  (void)address;
+#endif
+}
+
+/** values[i] = image->GetPixel(indices[i]): what PixelGather replaces. */
+template <typename TImage>
+void GetPixels(const TImage* const image, const std::vector<typename TImage::IndexType>& indices,
+               typename TImage::PixelType* const values)
+{
+  for(size_t i = 0; i < indices.size(); ++i)
+  {
+    values[i] = image->GetPixel(indices[i]);
+  }
+}
+
+template <typename TImage>
+class PixelGather
+{
+public:
+  typedef typename TImage::PixelType PixelType;
+  typedef typename TImage::IndexType IndexType;
+  typedef typename TImage::RegionType RegionType;
+
+  enum Order
+  {
+    IndexOrder,
+    SortOffsets
+  };
+
+  PixelGather() :
+    m_PrefetchDistance(0)
+  {
+  }
+
+  /** Every index must be inside the buffered region of 'image'. */
+  void SetIndices(const TImage* const image, const std::vector<IndexType>& indices, const Order order = IndexOrder)
+  {
+    m_Region = image->GetBufferedRegion();
+
+    std::vector<std::pair<itk::OffsetValueType, size_t> > offsets(indices.size());
+    for(size_t i = 0; i < indices.size(); ++i)
+    {
+      if(!m_Region.IsInside(indices[i]))
+      {
+        throw std::runtime_error("Cannot gather a pixel outside of the buffered region!");
+      }
+      offsets[i] = std::make_pair(image->ComputeOffset(indices[i]), i);
+    }
+    if(order == SortOffsets)
+    {
+      std::sort(offsets.begin(), offsets.end());
+    }
+
+    m_Offsets.resize(offsets.size());
+    m_ValueIds.resize(order == SortOffsets ? offsets.size() : 0);
+    for(size_t i = 0; i < offsets.size(); ++i)
+    {
+      m_Offsets[i] = offsets[i].first;
+      if(order == SortOffsets)
+      {
+        m_ValueIds[i] = offsets[i].second;
+      }
+    }
+  }
+
+  /** Loads ahead to prefetch; 0 (the default) does not prefetch. */
+  void SetPrefetchDistance(const size_t prefetchDistance)
+  {
+    m_PrefetchDistance = prefetchDistance;
+  }
+
+  size_t GetNumberOfIndices() const
+  {
+    return m_Offsets.size();
+  }
+
+  /** values[i] = the pixel at index i of the list; 'values' must have room for GetNumberOfIndices() pixels. */
+  void Gather(const TImage* const image, PixelType* const values) const
+  {
+    if(image->GetBufferedRegion() != m_Region)
+    {
+      throw std::runtime_error("Cannot gather from an image with another buffered region than the indices were set for!");
+    }
+
+    if(m_ValueIds.empty())
+    {
+      GatherLoop(image->GetBufferPointer(), values, IdentityValueId());
+    }
+    else
+    {
+      GatherLoop(image->GetBufferPointer(), values, SortedValueId(m_ValueIds));
+    }
+  }
+
+private:
+  struct IdentityValueId
+  {
+    size_t operator()(const size_t i) const
+    {
+      return i;
+    }
+  };
+
+  struct SortedValueId
+  {
+    explicit SortedValueId(const std::vector<size_t>& valueIds) :
+      ValueIds(&valueIds[0])
+    {
+    }
+
+    size_t operator()(const size_t i) const
+    {
+      return ValueIds[i];
+    }
+
+    const size_t* ValueIds;
+  };
+
+  /** The loop is duplicated for each order so that the plain one stays a plain loop. */
+  template <typename TValueId>
+  void GatherLoop(const PixelType* const buffer, PixelType* const values, const TValueId& valueId) const
+  {
+    const size_t numberOfOffsets = m_Offsets.size();
+    const itk::OffsetValueType* const offsets = numberOfOffsets > 0 ? &m_Offsets[0] : NULL;
+
+    size_t i = 0;
+    if(m_PrefetchDistance > 0)
+    {
+      // Stop prefetching before the end rather than checking every load for it
+      for(; i + m_PrefetchDistance < numberOfOffsets; ++i)
+      {
+        PrefetchForRead(buffer + offsets[i + m_PrefetchDistance]);
+        values[valueId(i)] = buffer[offsets[i]];
+      }
+    }
+    for(; i < numberOfOffsets; ++i)
+    {
+      values[valueId(i)] = buffer[offsets[i]];
+    }
+  }
+
+  RegionType m_Region;
+
+  /** In gather order */
+  std::vector<itk::OffsetValueType> m_Offsets;
+
+  /** Where each load goes in the values, in gather order; empty in index order. */
+  std::vector<size_t> m_ValueIds;
+
+  size_t m_PrefetchDistance;
+};
+
+} // end namespace GetPixelVsIterator
+
+#endif
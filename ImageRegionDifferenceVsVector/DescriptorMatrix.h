@@ -0,0 +1,144 @@
+/**
+ * All the descriptors of a set of patches in one block of memory, one row per descriptor.
+ *
+ * Unlike a std::vector<std::vector<float> >, building the matrix is a single allocation, and comparing a
+ * query to every descriptor reads memory front to back instead of following a pointer per descriptor.
+ * Rows start on a cache line boundary: the stride is the descriptor length rounded up to a cache line,
+ * and the padding is zero.
+ *
+ * The components are floats (DescriptorMatrix), or a smaller type for quantized descriptors (see
+ * PatchDistance/QuantizedDescriptors.h).
+ */
+
+#ifndef DescriptorMatrix_h
+#define DescriptorMatrix_h
+
+#include "ImageRegionDifferenceVsVector.h"
+
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace ImageRegionDifferenceVsVector
+{
+
+template <typename TComponent>
+class PackedDescriptorMatrix
+{
+public:
+  typedef TComponent ComponentType;
+
+  /** Bytes */
+  static const size_t Alignment = 64;
+
+  PackedDescriptorMatrix() :
+    m_NumberOfDescriptors(0), m_DescriptorLength(0), m_Stride(0), m_Data(NULL)
+    {
+    }
+
+  /** Discards the contents; the new descriptors are all zero. */
+  void SetSize(const size_t numberOfDescriptors, const size_t descriptorLength)
+    {
+    const size_t componentsPerAlignment = Alignment / sizeof(TComponent);
+
+    m_NumberOfDescriptors = numberOfDescriptors;
+    m_DescriptorLength = descriptorLength;
+    m_Stride = (descriptorLength + componentsPerAlignment - 1) / componentsPerAlignment * componentsPerAlignment;
+
+    // std::vector doesn't over-align, so allocate a spare alignment's worth and start at the first boundary
+    m_Storage.assign(numberOfDescriptors * m_Stride + componentsPerAlignment, TComponent());
+    const uintptr_t address = reinterpret_cast<uintptr_t>(&m_Storage[0]);
+    m_Data = &m_Storage[0] + ((Alignment - address % Alignment) % Alignment) / sizeof(TComponent);
+    }
+
+  size_t GetNumberOfDescriptors() const
+    {
+    return m_NumberOfDescriptors;
+    }
+
+  size_t GetDescriptorLength() const
+    {
+    return m_DescriptorLength;
+    }
+
+  /** The distance in components between the starts of consecutive descriptors. */
+  size_t GetStride() const
+    {
+    return m_Stride;
+    }
+
+  TComponent* GetDescriptor(const size_t descriptorId)
+    {
+    return m_Data + descriptorId * m_Stride;
+    }
+
+  const TComponent* GetDescriptor(const size_t descriptorId) const
+    {
+    return m_Data + descriptorId * m_Stride;
+    }
+
+private:
+  // Not copyable: m_Data points into m_Storage, and a copy may need a different offset to be aligned
+  PackedDescriptorMatrix(const PackedDescriptorMatrix&);
+  void operator=(const PackedDescriptorMatrix&);
+
+  size_t m_NumberOfDescriptors;
+  size_t m_DescriptorLength;
+  size_t m_Stride;
+
+  std::vector<TComponent> m_Storage;
+  TComponent* m_Data;
+};
+
+typedef PackedDescriptorMatrix<float> DescriptorMatrix;
+
+/** The descriptors (as MakeDescriptor() makes them) of 'regions', which must all have the same size and be inside
+ *  the buffered region, copied straight from the image buffer a row of pixels at a time. */
+inline void MakeDescriptorMatrix(const std::vector<itk::ImageRegion<2> >& regions, const ImageType* const image,
+                                 DescriptorMatrix& matrix)
+{
+  if(regions.empty())
+    {
+    matrix.SetSize(0, 0);
+    return;
+    }
+
+  const itk::Size<2> patchSize = regions[0].GetSize();
+  matrix.SetSize(regions.size(), patchSize[0] * patchSize[1]);
+
+  const float* const buffer = image->GetBufferPointer();
+  const size_t bufferWidth = image->GetBufferedRegion().GetSize()[0];
+
+  for(size_t regionId = 0; regionId < regions.size(); ++regionId)
+    {
+    if(regions[regionId].GetSize() != patchSize || !image->GetBufferedRegion().IsInside(regions[regionId]))
+      {
+      throw std::runtime_error("Cannot compute descriptor for region outside of image bounds or of another size!");
+      }
+
+    const float* row = buffer + image->ComputeOffset(regions[regionId].GetIndex());
+    float* descriptor = matrix.GetDescriptor(regionId);
+    for(itk::SizeValueType y = 0; y < patchSize[1]; ++y, row += bufferWidth, descriptor += patchSize[0])
+      {
+      std::copy(row, row + patchSize[0], descriptor);
+      }
+    }
+}
+
+/** differences[i] = Difference(query, descriptor i), visiting the descriptors in memory order. */
+inline void ComputeDifferences(const std::vector<float>& query, const DescriptorMatrix& matrix,
+                               std::vector<float>& differences)
+{
+  differences.resize(matrix.GetNumberOfDescriptors());
+
+  for(size_t descriptorId = 0; descriptorId < matrix.GetNumberOfDescriptors(); ++descriptorId)
+    {
+    differences[descriptorId] = Difference(&query[0], matrix.GetDescriptor(descriptorId), matrix.GetDescriptorLength());
+    }
+}
+
+} // end namespace ImageRegionDifferenceVsVector
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * Demo: Compute the difference between a patch and every other valid patch in an image,
+ *       either by iterating over the two image regions directly, or by first extracting
+ *       every patch into a std::vector<float> descriptor and comparing the descriptors.
+ *
+ *       DescriptorMatrix.h stores all the descriptors in one block instead of one std::vector each.
+ *
+ *       The "RowSpans" variant compares the two regions a row at a time (see ImageRowSpans.h), straight from
+ *       the image buffer.
+ *
+ *       The "Simple" variants compare a bare ImageRegionIterator loop to a loop over a std::vector.
+ */
+
+#ifndef ImageRegionDifferenceVsVector_h
+#define ImageRegionDifferenceVsVector_h
+
+#include "ImageRowSpans.h"
+
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+
+// STL
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace ImageRegionDifferenceVsVector
+{
+
+typedef itk::Image<float, 2> ImageType;
+
+const unsigned int patchRadius = 10;
+const unsigned int imageSize = 100;
+
+inline itk::ImageRegion<2> GetRegionInRadiusAroundPixel(const itk::Index<2>& pixel, const unsigned int radius)
+{
+  // This function returns a Region with the specified 'radius' centered at 'pixel'.
+  // By the definition of the radius of a square patch, the output region is (radius*2 + 1)x(radius*2 + 1).
+  // Note: This region is not necessarily entirely inside the image!
+
+  // The "index" is the lower left corner, so we need to subtract the radius from the center to obtain it
+  itk::Index<2> lowerLeft;
+  lowerLeft[0] = pixel[0] - radius;
+  lowerLeft[1] = pixel[1] - radius;
+
+  itk::ImageRegion<2> region;
+  region.SetIndex(lowerLeft);
+  itk::Size<2> size;
+  size[0] = radius*2 + 1;
+  size[1] = radius*2 + 1;
+  region.SetSize(size);
+
+  return region;
+}
+
+inline void CreateImage(ImageType* image)
+{
+  itk::Index<2> corner = {{0,0}};
+  itk::Size<2> size = {{imageSize, imageSize}};
+  itk::ImageRegion<2> fullRegion(corner, size);
+  image->SetRegions(fullRegion);
+  image->Allocate();
+
+  itk::ImageRegionIterator<ImageType> imageIterator(image, image->GetLargestPossibleRegion());
+
+  int i = 0;
+  while(!imageIterator.IsAtEnd())
+    {
+    imageIterator.Set(i);
+    i++;
+    ++imageIterator;
+    }
+}
+
+/** Every region of the given radius that is entirely inside the image. */
+inline std::vector<itk::ImageRegion<2> > GetAllValidRegions(ImageType* const image, const unsigned int radius)
+{
+  std::vector<itk::ImageRegion<2> > allRegions;
+
+  itk::ImageRegionIterator<ImageType> imageIterator(image, image->GetLargestPossibleRegion());
+
+  while(!imageIterator.IsAtEnd())
+    {
+    itk::ImageRegion<2> region = GetRegionInRadiusAroundPixel(imageIterator.GetIndex(), radius);
+    if(image->GetLargestPossibleRegion().IsInside(region))
+      {
+      allRegions.push_back(region);
+      }
+    ++imageIterator;
+    }
+
+  return allRegions;
+}
+
+inline std::vector<float> MakeDescriptor(const itk::ImageRegion<2>& region, ImageType* image)
+{
+  if(!image->GetLargestPossibleRegion().IsInside(region))
+    {
+    throw std::runtime_error("Cannot compute descriptor for region outside of image bounds!");
+    }
+
+  std::vector<float> descriptor;
+  descriptor.reserve(region.GetNumberOfPixels());
+
+  itk::ImageRegionIterator<ImageType> imageIterator(image, region);
+
+  while(!imageIterator.IsAtEnd())
+    {
+    descriptor.push_back(imageIterator.Get());
+
+    ++imageIterator;
+    }
+  return descriptor;
+}
+
+inline float Difference(const float* const a, const float* const b, const size_t length)
+{
+  float difference = 0.0f;
+  for(size_t i = 0; i < length; ++i)
+    {
+    difference += fabs(a[i] - b[i]);
+    }
+  return difference;
+}
+
+inline float Difference(const std::vector<float>& a, const std::vector<float>& b)
+{
+  return Difference(&a[0], &b[0], a.size());
+}
+
+inline float Difference(const itk::ImageRegion<2>& a, const itk::ImageRegion<2>& b, ImageType* const image)
+{
+  itk::ImageRegionIterator<ImageType> imageIteratorA(image, a);
+  itk::ImageRegionIterator<ImageType> imageIteratorB(image, b);
+
+  float difference = 0.0f;
+  while(!imageIteratorA.IsAtEnd())
+    {
+    difference += fabs(imageIteratorA.Get() - imageIteratorB.Get());
+
+    ++imageIteratorA;
+    ++imageIteratorB;
+    }
+
+  return difference;
+}
+
+/** The same as Difference(a, b, image); 'a' and 'b' must be inside the buffered region. */
+inline float DifferenceRowSpans(const itk::ImageRegion<2>& a, const itk::ImageRegion<2>& b, const ImageType* const image)
+{
+  if(!image->GetBufferedRegion().IsInside(b))
+    {
+    throw std::runtime_error("Cannot compute difference of a region outside of the buffered region!");
+    }
+
+  // Row y of 'b' is at the same distance in the buffer from row y of 'a' for every y
+  const itk::OffsetValueType offsetToB = image->ComputeOffset(b.GetIndex()) - image->ComputeOffset(a.GetIndex());
+
+  float difference = 0.0f;
+  ForEachRowSpan(image, a, [offsetToB, &difference](const float* rowA, const size_t length, const itk::Index<2>&)
+    {
+    difference += Difference(rowA, rowA + offsetToB, length);
+    });
+
+  return difference;
+}
+
+} // end namespace ImageRegionDifferenceVsVector
+
+#endif
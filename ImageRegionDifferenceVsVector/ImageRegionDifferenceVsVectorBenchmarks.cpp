@@ -0,0 +1,348 @@
+#include "ImageRegionDifferenceVsVector.h"
+#include "DescriptorMatrix.h"
+
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+#include "ThreadPool.h"
+
+// STL
+#include <numeric>
+
+using namespace ImageRegionDifferenceVsVector;
+
+namespace
+{
+
+/** The parallel cases always split the regions into this many chunks, whatever the number of threads, so that
+ *  the per-chunk sums and therefore the total are the same on any number of threads. */
+const size_t numberOfChunks = 64;
+
+/** The sum of function(i) for i in [0, count): each chunk sums its share in order, then the chunk sums are
+ *  added in chunk order. */
+template <typename TFunction>
+float ParallelSum(ThreadPool& pool, const size_t count, const TFunction& function)
+{
+  std::vector<float> chunkSums(numberOfChunks);
+  pool.ParallelFor(numberOfChunks, [&](const size_t chunkId)
+    {
+    float chunkSum = 0.0f;
+    for(size_t i = chunkId * count / numberOfChunks; i < (chunkId + 1) * count / numberOfChunks; ++i)
+      {
+      chunkSum += function(i);
+      }
+    chunkSums[chunkId] = chunkSum;
+    });
+
+  float sum = 0.0f;
+  for(size_t chunkId = 0; chunkId < numberOfChunks; ++chunkId)
+    {
+    sum += chunkSums[chunkId];
+    }
+  return sum;
+}
+
+void ITKImageCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  itk::Index<2> center = {{imageSize/2, imageSize/2}};
+  itk::ImageRegion<2> centerRegion = GetRegionInRadiusAroundPixel(center, patchRadius);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // patch comparisons
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    totalDifference = 0.0f;
+    for(size_t regionId = 0; regionId < allRegions.size(); ++regionId)
+      {
+      totalDifference += Difference(allRegions[regionId], centerRegion, image);
+      }
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+void RowSpansCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  itk::Index<2> center = {{imageSize/2, imageSize/2}};
+  itk::ImageRegion<2> centerRegion = GetRegionInRadiusAroundPixel(center, patchRadius);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // patch comparisons
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    totalDifference = 0.0f;
+    for(size_t regionId = 0; regionId < allRegions.size(); ++regionId)
+      {
+      totalDifference += DifferenceRowSpans(allRegions[regionId], centerRegion, image);
+      }
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+void VectorCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  itk::Index<2> center = {{imageSize/2, imageSize/2}};
+  itk::ImageRegion<2> centerRegion = GetRegionInRadiusAroundPixel(center, patchRadius);
+  std::vector<float> centerDescriptor = MakeDescriptor(centerRegion, image);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // patch comparisons
+
+  std::vector<std::vector<float> > allDescriptors;
+  for(size_t regionId = 0; regionId < allRegions.size(); ++regionId)
+    {
+    allDescriptors.push_back(MakeDescriptor(allRegions[regionId], image));
+    }
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    totalDifference = 0.0f;
+    for(unsigned int i = 0; i < allDescriptors.size(); ++i)
+      {
+      totalDifference += Difference(centerDescriptor, allDescriptors[i]);
+      }
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+void DescriptorMatrixCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  itk::Index<2> center = {{imageSize/2, imageSize/2}};
+  itk::ImageRegion<2> centerRegion = GetRegionInRadiusAroundPixel(center, patchRadius);
+  std::vector<float> centerDescriptor = MakeDescriptor(centerRegion, image);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // patch comparisons
+
+  DescriptorMatrix allDescriptors;
+  MakeDescriptorMatrix(allRegions, image, allDescriptors);
+
+  std::vector<float> differences;
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    ComputeDifferences(centerDescriptor, allDescriptors, differences);
+    totalDifference = 0.0f;
+    for(size_t i = 0; i < differences.size(); ++i)
+      {
+      totalDifference += differences[i];
+      }
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+/** Extracting the descriptors of every patch, which the Vector case does once before its measured loop. */
+void BuildVectorsCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // descriptors
+
+  while(state.KeepRunning())
+    {
+    std::vector<std::vector<float> > allDescriptors;
+    for(size_t regionId = 0; regionId < allRegions.size(); ++regionId)
+      {
+      allDescriptors.push_back(MakeDescriptor(allRegions[regionId], image));
+      }
+    DoNotOptimize(allDescriptors.data());
+    ClobberMemory();
+    }
+
+  // The sum of every descriptor
+  double checksum = 0;
+  for(size_t regionId = 0; regionId < allRegions.size(); ++regionId)
+    {
+    std::vector<float> descriptor = MakeDescriptor(allRegions[regionId], image);
+    checksum += std::accumulate(descriptor.begin(), descriptor.end(), 0.0);
+    }
+  state.SetChecksum(checksum);
+}
+
+void BuildDescriptorMatrixCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // descriptors
+
+  while(state.KeepRunning())
+    {
+    DescriptorMatrix allDescriptors;
+    MakeDescriptorMatrix(allRegions, image, allDescriptors);
+    DoNotOptimize(allDescriptors.GetDescriptor(0));
+    ClobberMemory();
+    }
+
+  // The sum of every descriptor
+  DescriptorMatrix allDescriptors;
+  MakeDescriptorMatrix(allRegions, image, allDescriptors);
+  double checksum = 0;
+  for(size_t regionId = 0; regionId < allRegions.size(); ++regionId)
+    {
+    const float* const descriptor = allDescriptors.GetDescriptor(regionId);
+    checksum += std::accumulate(descriptor, descriptor + allDescriptors.GetDescriptorLength(), 0.0);
+    }
+  state.SetChecksum(checksum);
+}
+
+void ParallelITKImageCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  itk::Index<2> center = {{imageSize/2, imageSize/2}};
+  itk::ImageRegion<2> centerRegion = GetRegionInRadiusAroundPixel(center, patchRadius);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // patch comparisons
+
+  ThreadPool pool(state.GetNumberOfThreads());
+  ImageType* const imagePointer = image; // Only read by the threads
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    totalDifference = ParallelSum(pool, allRegions.size(), [&](const size_t regionId)
+      {
+      return Difference(allRegions[regionId], centerRegion, imagePointer);
+      });
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+void ParallelVectorCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  itk::Index<2> center = {{imageSize/2, imageSize/2}};
+  itk::ImageRegion<2> centerRegion = GetRegionInRadiusAroundPixel(center, patchRadius);
+  std::vector<float> centerDescriptor = MakeDescriptor(centerRegion, image);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // patch comparisons
+
+  std::vector<std::vector<float> > allDescriptors;
+  for(size_t regionId = 0; regionId < allRegions.size(); ++regionId)
+    {
+    allDescriptors.push_back(MakeDescriptor(allRegions[regionId], image));
+    }
+
+  ThreadPool pool(state.GetNumberOfThreads());
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    totalDifference = ParallelSum(pool, allDescriptors.size(), [&](const size_t i)
+      {
+      return Difference(centerDescriptor, allDescriptors[i]);
+      });
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+void SimpleITKImageCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+
+  itk::Index<2> corner = {{0,0}};
+  itk::Size<2> size = {{20, 20}};
+  itk::ImageRegion<2> region(corner, size);
+  image->SetRegions(region);
+  image->Allocate();
+  state.SetItemsPerIteration(region.GetNumberOfPixels());
+
+  while(state.KeepRunning())
+    {
+    itk::ImageRegionIterator<ImageType> imageIterator(image, region);
+    while(!imageIterator.IsAtEnd())
+      {
+      float a = imageIterator.Get() - imageIterator.Get();
+      DoNotOptimize(a); // Otherwise the whole loop is dead code
+
+      ++imageIterator;
+      }
+    }
+}
+
+void SimpleRowSpansCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+
+  itk::Index<2> corner = {{0,0}};
+  itk::Size<2> size = {{20, 20}};
+  itk::ImageRegion<2> region(corner, size);
+  image->SetRegions(region);
+  image->Allocate();
+  state.SetItemsPerIteration(region.GetNumberOfPixels());
+
+  while(state.KeepRunning())
+    {
+    ForEachRowSpan(image.GetPointer(), region, [](const float* row, const size_t length, const itk::Index<2>&)
+      {
+      for(size_t i = 0; i < length; ++i)
+        {
+        float a = row[i] - row[i];
+        DoNotOptimize(a); // Otherwise the whole loop is dead code
+        }
+      });
+    }
+}
+
+void SimpleVectorCase(BenchmarkState& state)
+{
+  std::vector<float> vec(400);
+  state.SetItemsPerIteration(vec.size());
+  DoNotOptimize(vec.data()); // vec is all zeros, so without this a - a could be constant folded
+
+  while(state.KeepRunning())
+    {
+    for(unsigned int i = 0; i < vec.size(); ++i)
+      {
+      float a = vec[i] - vec[i];
+      DoNotOptimize(a); // Otherwise the whole loop is dead code
+      }
+    }
+}
+
+} // end anonymous namespace
+
+void RegisterImageRegionDifferenceVsVectorBenchmarks(BenchmarkRegistry& registry)
+{
+  registry.Add("ImageRegionDifferenceVsVector/ITKImage", ITKImageCase);
+  registry.Add("ImageRegionDifferenceVsVector/RowSpans", RowSpansCase);
+  registry.Add("ImageRegionDifferenceVsVector/Vector", VectorCase);
+  registry.Add("ImageRegionDifferenceVsVector/DescriptorMatrix", DescriptorMatrixCase);
+  registry.Add("ImageRegionDifferenceVsVector/BuildVectors", BuildVectorsCase);
+  registry.Add("ImageRegionDifferenceVsVector/BuildDescriptorMatrix", BuildDescriptorMatrixCase);
+  registry.AddMultiThreaded("ImageRegionDifferenceVsVector/ParallelITKImage", ParallelITKImageCase);
+  registry.AddMultiThreaded("ImageRegionDifferenceVsVector/ParallelVector", ParallelVectorCase);
+  registry.Add("ImageRegionDifferenceVsVector/SimpleITKImage", SimpleITKImageCase);
+  registry.Add("ImageRegionDifferenceVsVector/SimpleRowSpans", SimpleRowSpansCase);
+  registry.Add("ImageRegionDifferenceVsVector/SimpleVector", SimpleVectorCase);
+}
@@ -0,0 +1,85 @@
+#include "IteratorWithIndex.h"
+
+#include "BenchmarkImageTypes.h"
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+namespace
+{
+
+template <typename TImage>
+void IteratorCase(BenchmarkState& state)
+{
+  typename TImage::Pointer image = TImage::New();
+  AllocateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * sizeof(typename TImage::PixelType));
+
+  unsigned int counter = 0;
+  while(state.KeepRunning())
+  {
+    counter = IteratorWithIndex::Iterator(image.GetPointer());
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+template <typename TImage>
+void IteratorWithIndexCase(BenchmarkState& state)
+{
+  typename TImage::Pointer image = TImage::New();
+  AllocateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * sizeof(typename TImage::PixelType));
+
+  unsigned int counter = 0;
+  while(state.KeepRunning())
+  {
+    counter = IteratorWithIndex::IteratorWithIndex(image.GetPointer());
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+template <typename TImage>
+void RowSpansCase(BenchmarkState& state)
+{
+  typename TImage::Pointer image = TImage::New();
+  AllocateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * sizeof(typename TImage::PixelType));
+
+  unsigned int counter = 0;
+  while(state.KeepRunning())
+  {
+    counter = IteratorWithIndex::RowSpans(image.GetPointer());
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+struct Registrar
+{
+  BenchmarkRegistry& Registry;
+
+  template <typename TImage>
+  void Register() const
+  {
+    const std::string imageTypeName = GetImageTypeName<TImage>();
+    Registry.Add("IteratorWithIndex/Iterator/" + imageTypeName, IteratorCase<TImage>, 10);
+    Registry.Add("IteratorWithIndex/IteratorWithIndex/" + imageTypeName, IteratorWithIndexCase<TImage>, 10);
+    Registry.Add("IteratorWithIndex/RowSpans/" + imageTypeName, RowSpansCase<TImage>, 10);
+  }
+};
+
+} // end anonymous namespace
+
+void RegisterIteratorWithIndexBenchmarks(BenchmarkRegistry& registry)
+{
+  // For uint8/2D, 1e7 iterations took about 7.2 (Iterator) and 2.6 (IteratorWithIndex) seconds in the original demo
+  Registrar registrar = {registry};
+  ForEachImageType(registrar);
+}
@@ -0,0 +1,239 @@
+/**
+ * The face, edge and vertex connected neighborhoods of a pixel (4 and 8 connected in 2D, 6, 18 and 26
+ * connected in 3D) as compile time constants, for queries that run in the inner loop of a flood fill or a
+ * connected component labeling.
+ *
+ * Neighbor i of FixedNeighborhood<VDimension, VConnectivity> is at GetOffset<i>() (or GetOffset(i)), in row-major
+ * order of the 3^VDimension cube around the pixel. A neighbor is a pixel of the cube other than its center
+ * with at most MaximumNonZeroComponents non-zero offset components: 1 for the 4 and 6 connected neighborhoods,
+ * 2 for the 8 and 18 connected ones and 3 for the 26 connected one. The offsets are constexpr, and the
+ * loops over the neighbors are unrolled by recursion over the neighbor number, so each access is a load
+ * at a constant combination of the image's strides.
+ *
+ * GetNeighborsWithValue() returns a NeighborMask, with bit i set if neighbor i has the value, instead of
+ * filling a std::vector; GetNeighbor() turns a bit back into an index.
+ */
+
+#ifndef FixedNeighborhood_h
+#define FixedNeighborhood_h
+
+// ITK
+#include "itkImage.h"
+
+// STL
+#include <cstdint>
+
+namespace NeighborhoodIterator
+{
+
+/** Bit i is neighbor i. */
+typedef std::uint32_t NeighborMask;
+
+inline constexpr unsigned int PowerOf3(const unsigned int exponent)
+{
+  return exponent == 0 ? 1 : 3 * PowerOf3(exponent - 1);
+}
+
+/** The offset along 'dimension' of pixel 'cubeId' of the 3x3(x3) cube, in row-major order. */
+inline constexpr int GetCubeOffset(const unsigned int cubeId, const unsigned int dimension)
+{
+  return static_cast<int>(cubeId / PowerOf3(dimension) % 3) - 1;
+}
+
+inline constexpr unsigned int GetNumberOfNonZeroComponents(const unsigned int cubeId, const unsigned int dimension)
+{
+  return dimension == 0 ? 0 :
+    (GetCubeOffset(cubeId, dimension - 1) != 0) + GetNumberOfNonZeroComponents(cubeId, dimension - 1);
+}
+
+inline constexpr bool IsCubeNeighbor(const unsigned int cubeId, const unsigned int dimension,
+                                     const unsigned int maximumNonZeroComponents)
+{
+  return cubeId != PowerOf3(dimension) / 2 &&
+    GetNumberOfNonZeroComponents(cubeId, dimension) <= maximumNonZeroComponents;
+}
+
+/** The cube pixel of neighbor 'neighbor', counting the neighbors from 'cubeId' on. */
+inline constexpr unsigned int GetNeighborCubeId(const unsigned int neighbor, const unsigned int dimension,
+                                                const unsigned int maximumNonZeroComponents,
+                                                const unsigned int cubeId = 0)
+{
+  return !IsCubeNeighbor(cubeId, dimension, maximumNonZeroComponents) ?
+    GetNeighborCubeId(neighbor, dimension, maximumNonZeroComponents, cubeId + 1) :
+    neighbor == 0 ? cubeId : GetNeighborCubeId(neighbor - 1, dimension, maximumNonZeroComponents, cubeId + 1);
+}
+
+inline constexpr unsigned int CountCubeNeighbors(const unsigned int dimension,
+                                                 const unsigned int maximumNonZeroComponents,
+                                                 const unsigned int cubeId = 0)
+{
+  return cubeId == PowerOf3(dimension) ? 0 :
+    IsCubeNeighbor(cubeId, dimension, maximumNonZeroComponents) +
+    CountCubeNeighbors(dimension, maximumNonZeroComponents, cubeId + 1);
+}
+
+/** Only the connectivities below are defined. */
+template <unsigned int VDimension, unsigned int VConnectivity>
+struct ConnectivityTraits;
+
+template <>
+struct ConnectivityTraits<2, 4>
+{
+  static const unsigned int MaximumNonZeroComponents = 1;
+};
+
+template <>
+struct ConnectivityTraits<2, 8>
+{
+  static const unsigned int MaximumNonZeroComponents = 2;
+};
+
+template <>
+struct ConnectivityTraits<3, 6>
+{
+  static const unsigned int MaximumNonZeroComponents = 1;
+};
+
+template <>
+struct ConnectivityTraits<3, 18>
+{
+  static const unsigned int MaximumNonZeroComponents = 2;
+};
+
+template <>
+struct ConnectivityTraits<3, 26>
+{
+  static const unsigned int MaximumNonZeroComponents = 3;
+};
+
+template <unsigned int VDimension, unsigned int VConnectivity>
+struct FixedNeighborhood
+{
+  typedef itk::Offset<VDimension> OffsetType;
+
+  static const unsigned int Dimension = VDimension;
+  static const unsigned int NumberOfNeighbors = VConnectivity;
+  static const unsigned int MaximumNonZeroComponents =
+    ConnectivityTraits<VDimension, VConnectivity>::MaximumNonZeroComponents;
+
+  static_assert(CountCubeNeighbors(VDimension, MaximumNonZeroComponents) == NumberOfNeighbors,
+                "The connectivity is not the number of neighbors it selects!");
+  static_assert(NumberOfNeighbors <= 8 * sizeof(NeighborMask), "A NeighborMask is too small for the neighborhood!");
+
+  /** The offset of neighbor VNeighbor, from constants only (the constexpr variable forces the search for its
+   *  cube pixel to happen at compile time, which the optimizer doesn't always do for a recursive call). */
+  template <unsigned int VNeighbor>
+  static OffsetType GetOffset()
+  {
+    constexpr unsigned int cubeId = GetNeighborCubeId(VNeighbor, VDimension, MaximumNonZeroComponents);
+    return GetCubeOffset(cubeId);
+  }
+
+  static OffsetType GetOffset(const unsigned int neighbor)
+  {
+    return GetCubeOffset(GetNeighborCubeId(neighbor, VDimension, MaximumNonZeroComponents));
+  }
+
+private:
+  static OffsetType GetCubeOffset(unsigned int cubeId)
+  {
+    OffsetType offset;
+    for(unsigned int dimension = 0; dimension < VDimension; ++dimension, cubeId /= 3)
+    {
+      offset[dimension] = static_cast<itk::OffsetValueType>(cubeId % 3) - 1;
+    }
+    return offset;
+  }
+};
+
+/** Calls function(neighbor, offset) for every neighbor of TNeighborhood, unrolled, so both are constants in
+ *  each call. */
+template <typename TNeighborhood, unsigned int VNeighbor = 0,
+          bool VEnd = VNeighbor == TNeighborhood::NumberOfNeighbors>
+struct UnrolledNeighbors
+{
+  template <typename TFunction>
+  static void Visit(TFunction& function)
+  {
+    function(VNeighbor, TNeighborhood::template GetOffset<VNeighbor>());
+    UnrolledNeighbors<TNeighborhood, VNeighbor + 1>::Visit(function);
+  }
+};
+
+template <typename TNeighborhood, unsigned int VNeighbor>
+struct UnrolledNeighbors<TNeighborhood, VNeighbor, true>
+{
+  template <typename TFunction>
+  static void Visit(TFunction&)
+  {
+  }
+};
+
+template <unsigned int VConnectivity, unsigned int VDimension>
+itk::Index<VDimension> GetNeighbor(const itk::Index<VDimension>& pixel, const unsigned int neighbor)
+{
+  return pixel + FixedNeighborhood<VDimension, VConnectivity>::GetOffset(neighbor);
+}
+
+/** The neighbors of 'pixel' (which must be in the buffered region) with 'value'; those outside of the buffered
+ *  region are never set. */
+template <unsigned int VConnectivity, typename TImage>
+NeighborMask GetNeighborsWithValue(const TImage* const image, const typename TImage::IndexType& pixel,
+                                   const typename TImage::PixelType& value)
+{
+  typedef FixedNeighborhood<TImage::ImageDimension, VConnectivity> NeighborhoodType;
+  typedef typename TImage::PixelType PixelType;
+
+  const typename TImage::RegionType& bufferedRegion = image->GetBufferedRegion();
+  bool interior = true;
+  for(unsigned int dimension = 0; dimension < TImage::ImageDimension; ++dimension)
+  {
+    const itk::IndexValueType position = pixel[dimension] - bufferedRegion.GetIndex()[dimension];
+    interior &= position >= 1 && position + 1 < static_cast<itk::IndexValueType>(bufferedRegion.GetSize()[dimension]);
+  }
+
+  NeighborMask neighbors = 0;
+  if(interior)
+  {
+    const PixelType* const center = image->GetBufferPointer() + image->ComputeOffset(pixel);
+    const itk::OffsetValueType* const offsetTable = image->GetOffsetTable();
+    auto testNeighbor = [&](const unsigned int neighbor, const typename NeighborhoodType::OffsetType& offset)
+    {
+      itk::OffsetValueType linearOffset = 0;
+      for(unsigned int dimension = 0; dimension < TImage::ImageDimension; ++dimension)
+      {
+        linearOffset += offset[dimension] * offsetTable[dimension];
+      }
+      neighbors |= static_cast<NeighborMask>(center[linearOffset] == value) << neighbor;
+    };
+    UnrolledNeighbors<NeighborhoodType>::Visit(testNeighbor);
+  }
+  else
+  {
+    auto testNeighbor = [&](const unsigned int neighbor, const typename NeighborhoodType::OffsetType& offset)
+    {
+      const typename TImage::IndexType neighborIndex = pixel + offset;
+      if(bufferedRegion.IsInside(neighborIndex) && image->GetPixel(neighborIndex) == value)
+      {
+        neighbors |= NeighborMask(1) << neighbor;
+      }
+    };
+    UnrolledNeighbors<NeighborhoodType>::Visit(testNeighbor);
+  }
+  return neighbors;
+}
+
+/** The number of bits set in 'neighbors'. */
+inline unsigned int CountNeighbors(NeighborMask neighbors)
+{
+  unsigned int count = 0;
+  for(; neighbors != 0; neighbors &= neighbors - 1)
+  {
+    ++count;
+  }
+  return count;
+}
+
+} // end namespace NeighborhoodIterator
+
+#endif
@@ -0,0 +1,152 @@
+/**
+ * Which 8-neighbors have a value, for every pixel of a 2D image at once.
+ *
+ * Compute8NeighborMasks() writes, for every pixel, the NeighborMask that GetNeighborsWithValue<8>() would
+ * return for it (bit i is neighbor i of FixedNeighborhood<2, 8>, neighbors outside of the image are never
+ * set) into an 8 bit image. It works a row at a time: each image row is compared to the value once, into a
+ * row of 0/1 bytes padded with a 0 at both ends, and the masks of a row are put together from the
+ * previous, current and next match rows shifted by -1, 0 and +1 pixels. Both loops are plain loops over
+ * a row without a branch, which the compiler vectorizes, and the padding stands in for the neighbors
+ * beyond the left and right borders.
+ *
+ * Compute8NeighborMasksParallel() splits the rows into blocks computed on a ThreadPool; each block
+ * compares the rows just above and below it itself.
+ */
+
+#ifndef NeighborMasks_h
+#define NeighborMasks_h
+
+#include "FixedNeighborhood.h"
+#include "ThreadPool.h"
+
+// ITK
+#include "itkImage.h"
+
+// STL
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace NeighborhoodIterator
+{
+
+typedef itk::Image<std::uint8_t, 2> NeighborMaskImageType;
+
+/** matches[x + 1] = row[x] == value; matches[0] and matches[width + 1] are 0. */
+template <typename TPixel>
+void CompareRow(const TPixel* const row, const size_t width, const TPixel& value, std::uint8_t* const matches)
+{
+  matches[0] = 0;
+  for(size_t x = 0; x < width; ++x)
+  {
+    matches[x + 1] = row[x] == value;
+  }
+  matches[width + 1] = 0;
+}
+
+/** The masks of one row from the padded match rows above, of and below it. */
+inline void CombineMatchRows(const std::uint8_t* const above, const std::uint8_t* const center,
+                             const std::uint8_t* const below, const size_t width, std::uint8_t* const masks)
+{
+  // The bits are in the order of the neighbors of FixedNeighborhood<2, 8>
+  for(size_t x = 0; x < width; ++x)
+  {
+    masks[x] = static_cast<std::uint8_t>(above[x] | above[x + 1] << 1 | above[x + 2] << 2 |
+                                         center[x] << 3 | center[x + 2] << 4 |
+                                         below[x] << 5 | below[x + 1] << 6 | below[x + 2] << 7);
+  }
+}
+
+/** Computes the masks of rows [firstRow, endRow) of the buffer. */
+template <typename TImage>
+void Compute8NeighborMaskRows(const TImage* const image, const typename TImage::PixelType& value,
+                              NeighborMaskImageType* const masks, const size_t firstRow, const size_t endRow)
+{
+  typedef typename TImage::PixelType PixelType;
+
+  const size_t width = image->GetBufferedRegion().GetSize()[0];
+  const size_t height = image->GetBufferedRegion().GetSize()[1];
+  const PixelType* const buffer = image->GetBufferPointer();
+
+  // Match rows for the rows above, of and below the current one, rotated as the current row moves down.
+  // Rows outside of the image have no matches.
+  std::vector<std::uint8_t> matchRows(3 * (width + 2), 0);
+  std::uint8_t* above = &matchRows[0];
+  std::uint8_t* center = above + width + 2;
+  std::uint8_t* below = center + width + 2;
+
+  if(firstRow > 0)
+  {
+    CompareRow(buffer + (firstRow - 1) * width, width, value, above);
+  }
+  CompareRow(buffer + firstRow * width, width, value, center);
+
+  for(size_t y = firstRow; y < endRow; ++y)
+  {
+    if(y + 1 < height)
+    {
+      CompareRow(buffer + (y + 1) * width, width, value, below);
+    }
+    else
+    {
+      std::fill(below, below + width + 2, 0);
+    }
+
+    CombineMatchRows(above, center, below, width, masks->GetBufferPointer() + y * width);
+
+    std::uint8_t* const oldAbove = above;
+    above = center;
+    center = below;
+    below = oldAbove;
+  }
+}
+
+/** Allocates 'masks' with the buffered region of 'image' unless it already has it. */
+template <typename TImage>
+void Allocate8NeighborMasks(const TImage* const image, NeighborMaskImageType* const masks)
+{
+  static_assert(TImage::ImageDimension == 2, "8-neighbor masks are for 2D images!");
+
+  if(masks->GetBufferedRegion() != image->GetBufferedRegion())
+  {
+    masks->SetRegions(image->GetBufferedRegion());
+    masks->Allocate();
+  }
+}
+
+template <typename TImage>
+void Compute8NeighborMasks(const TImage* const image, const typename TImage::PixelType& value,
+                           NeighborMaskImageType* const masks)
+{
+  Allocate8NeighborMasks(image, masks);
+
+  const size_t height = image->GetBufferedRegion().GetSize()[1];
+  if(image->GetBufferedRegion().GetNumberOfPixels() > 0)
+  {
+    Compute8NeighborMaskRows(image, value, masks, 0, height);
+  }
+}
+
+template <typename TImage>
+void Compute8NeighborMasksParallel(const TImage* const image, const typename TImage::PixelType& value,
+                                   NeighborMaskImageType* const masks, ThreadPool& pool)
+{
+  Allocate8NeighborMasks(image, masks);
+  if(image->GetBufferedRegion().GetNumberOfPixels() == 0)
+  {
+    return;
+  }
+
+  // Several blocks per thread to balance the load; each block compares two rows more than it writes
+  const size_t height = image->GetBufferedRegion().GetSize()[1];
+  const size_t numberOfBlocks = std::min<size_t>(height, 4 * pool.GetNumberOfThreads());
+  pool.ParallelFor(numberOfBlocks, [&](const size_t blockId)
+  {
+    Compute8NeighborMaskRows(image, value, masks, blockId * height / numberOfBlocks,
+                             (blockId + 1) * height / numberOfBlocks);
+  });
+}
+
+} // end namespace NeighborhoodIterator
+
+#endif
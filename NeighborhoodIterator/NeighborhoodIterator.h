@@ -1,11 +1,22 @@
 /**
  * Demo: Compare the process of visiting each neighbor of a pixel by computing its neighbors and using GetPixel()
- *       versus using a NeighborhoodIterator and skipping the center pixel.
+ *       versus using a NeighborhoodIterator and skipping the center pixel,
+ *       versus visiting the 3x3 region around the pixel as three rows (see ImageRowSpans.h),
+ *       versus the compile time neighborhoods of FixedNeighborhood.h, which return a bitmask instead of a std::vector.
+ *       When every pixel needs its neighbors, Compute8NeighborMasks() (see NeighborMasks.h) computes the masks of
+ *       the whole image a row at a time.
  *
  * Conclusion:
  * It is about 2x as fast to use a NeighborhoodIterator.
  */
 
+#ifndef NeighborhoodIterator_h
+#define NeighborhoodIterator_h
+
+#include "FixedNeighborhood.h"
+#include "ImageRowSpans.h"
+#include "NeighborMasks.h"
+
 // ITK
 #include "itkImage.h"
 #include "itkConstNeighborhoodIterator.h"
@@ -13,8 +24,11 @@
 // STL
 #include <vector>
 
+namespace NeighborhoodIterator
+{
+
 ////////////// Method 1 /////////////////////////
-std::vector<itk::Offset<2> > Get8NeighborOffsets()
+inline std::vector<itk::Offset<2> > Get8NeighborOffsets()
 {
   std::vector<itk::Offset<2> > offsets;
 
@@ -35,7 +49,7 @@ std::vector<itk::Offset<2> > Get8NeighborOffsets()
   return offsets;
 }
 
-std::vector<itk::Index<2> > Get8Neighbors(const itk::Index<2>& pixel)
+inline std::vector<itk::Index<2> > Get8Neighbors(const itk::Index<2>& pixel)
 {
   std::vector<itk::Index<2> > neighborsInRegion;
 
@@ -106,34 +120,42 @@ std::vector<itk::Index<2> > Get8NeighborsWithValueFast(const itk::Index<2>& pixe
   return neighborsWithValue;
 }
 
-int main(int, char* [] )
+///////////////////////////////////////////// Method 3 //////////////////////
+template<typename TImage>
+std::vector<itk::Index<2> > Get8NeighborsWithValueRowSpans(const itk::Index<2>& pixel, const TImage* const image,
+                                                           const typename TImage::PixelType& value)
 {
-  typedef itk::Image<unsigned char, 2> ImageType;
-  ImageType::Pointer image = ImageType::New();
-
-  itk::Index<2> corner={{0,0}};
-  itk::Size<2> size = {{10,10}};
-  itk::ImageRegion<2> region(corner,size);
-  image->SetRegions(region);
-  image->Allocate();
-
-  // This is the pixel we will repeatedly query
-  itk::Index<2> center = {{5,5}};
-
-  unsigned char searchValue = 255;
-
-  // This pixel (an 8-neighbor of center) we set to the search value
-  itk::Index<2> otherPixel = {{4,4}};
-  image->SetPixel(otherPixel, searchValue);
+  std::vector<itk::Index<2> > neighborsWithValue;
 
-  int totalSize = 0;
-  for(unsigned int i = 0; i < 1e6; ++i)
+  // The 3x3 region centered on the pixel, without the neighbors outside of the image
+  itk::Index<2> corner = {{pixel[0] - 1, pixel[1] - 1}};
+  itk::Size<2> size = {{3, 3}};
+  itk::ImageRegion<2> neighborhood(corner, size);
+  if(!neighborhood.Crop(image->GetBufferedRegion()))
   {
-    std::vector<itk::Index<2> > neighbors = Get8NeighborsWithValue(center, image.GetPointer(), searchValue);
-//    std::vector<itk::Index<2> > neighbors = Get8NeighborsWithValueFast(center, image.GetPointer(), searchValue);
-    totalSize += neighbors.size();
+    return neighborsWithValue;
   }
 
-  std::cout << "totalSize " << totalSize << std::endl;
-  return 0;
+  ForEachRowSpan(image, neighborhood, [&](const typename TImage::PixelType* row, const size_t length,
+                                          const itk::Index<2>& rowStart)
+  {
+    for(size_t i = 0; i < length; ++i)
+    {
+      if(row[i] == value)
+      {
+        itk::Index<2> neighbor = rowStart;
+        neighbor[0] += i;
+        if(neighbor != pixel) // The query pixel itself is not a neighbor
+        {
+          neighborsWithValue.push_back(neighbor);
+        }
+      }
+    }
+  });
+
+  return neighborsWithValue;
 }
+
+} // end namespace NeighborhoodIterator
+
+#endif
@@ -0,0 +1,228 @@
+#include "NeighborhoodIterator.h"
+
+#include "BenchmarkImageTypes.h"
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+// ITK
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+
+typedef itk::Image<unsigned char, 2> ImageType;
+typedef itk::Image<unsigned char, 3> Image3DType;
+
+const unsigned char searchValue = 255;
+
+/** About imageSize^2 pixels whatever the dimension (see AllocateImage()), so 3D images sweep the same working
+ *  sets as 2D ones. */
+template <typename TImage>
+void CreateImage(TImage* const image, const unsigned int imageSize)
+{
+  AllocateImage(image, imageSize);
+  image->FillBuffer(0);
+  const typename TImage::RegionType region = image->GetLargestPossibleRegion();
+
+  // Every fourth pixel of every fourth row (and slice) is the search value, so most queries find one neighbor
+  itk::ImageRegionIteratorWithIndex<TImage> imageIterator(image, region);
+  while(!imageIterator.IsAtEnd())
+  {
+    bool isSearchPixel = true;
+    for(unsigned int dimension = 0; dimension < TImage::ImageDimension; ++dimension)
+    {
+      isSearchPixel &= imageIterator.GetIndex()[dimension] % 4 == 0;
+    }
+    if(isSearchPixel)
+    {
+      imageIterator.Set(searchValue);
+    }
+    ++imageIterator;
+  }
+}
+
+/** The query pixel moves through the interior of the image in row-major order, one pixel per iteration,
+ *  so that the neighborhoods visited (and the working set) grow with the image. */
+template <unsigned int VDimension>
+void NextQueryPixel(itk::Index<VDimension>& pixel, const itk::Size<VDimension>& imageSize)
+{
+  for(unsigned int dimension = 0; dimension < VDimension; ++dimension)
+  {
+    if(++pixel[dimension] < static_cast<itk::IndexValueType>(imageSize[dimension]) - 1)
+    {
+      return;
+    }
+    pixel[dimension] = 1;
+  }
+}
+
+void Get8NeighborsWithValueCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const ImageType::SizeType imageSize = image->GetLargestPossibleRegion().GetSize();
+  state.SetItemsPerIteration(8);
+  state.SetBytesPerIteration(8 * sizeof(ImageType::PixelType));
+
+  itk::Index<2> queryPixel = {{1,1}};
+  int totalSize = 0;
+  while(state.KeepRunning())
+  {
+    std::vector<itk::Index<2> > neighbors =
+      NeighborhoodIterator::Get8NeighborsWithValue(queryPixel, image.GetPointer(), searchValue);
+    totalSize = neighbors.size();
+    DoNotOptimize(totalSize);
+    NextQueryPixel(queryPixel, imageSize);
+  }
+  state.SetChecksum(totalSize);
+}
+
+void Get8NeighborsWithValueFastCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const ImageType::SizeType imageSize = image->GetLargestPossibleRegion().GetSize();
+  state.SetItemsPerIteration(8);
+  state.SetBytesPerIteration(8 * sizeof(ImageType::PixelType));
+
+  itk::Index<2> queryPixel = {{1,1}};
+  int totalSize = 0;
+  while(state.KeepRunning())
+  {
+    std::vector<itk::Index<2> > neighbors =
+      NeighborhoodIterator::Get8NeighborsWithValueFast(queryPixel, image.GetPointer(), searchValue);
+    totalSize = neighbors.size();
+    DoNotOptimize(totalSize);
+    NextQueryPixel(queryPixel, imageSize);
+  }
+  state.SetChecksum(totalSize);
+}
+
+void Get8NeighborsWithValueRowSpansCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const ImageType::SizeType imageSize = image->GetLargestPossibleRegion().GetSize();
+  state.SetItemsPerIteration(8);
+  state.SetBytesPerIteration(8 * sizeof(ImageType::PixelType));
+
+  itk::Index<2> queryPixel = {{1,1}};
+  int totalSize = 0;
+  while(state.KeepRunning())
+  {
+    std::vector<itk::Index<2> > neighbors =
+      NeighborhoodIterator::Get8NeighborsWithValueRowSpans(queryPixel, image.GetPointer(), searchValue);
+    totalSize = neighbors.size();
+    DoNotOptimize(totalSize);
+    NextQueryPixel(queryPixel, imageSize);
+  }
+  state.SetChecksum(totalSize);
+}
+
+template <typename TImage, unsigned int VConnectivity>
+void GetNeighborsWithValueFixedCase(BenchmarkState& state)
+{
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const typename TImage::SizeType imageSize = image->GetLargestPossibleRegion().GetSize();
+  state.SetItemsPerIteration(VConnectivity);
+  state.SetBytesPerIteration(VConnectivity * sizeof(typename TImage::PixelType));
+
+  typename TImage::IndexType queryPixel;
+  queryPixel.Fill(1);
+  int totalSize = 0;
+  while(state.KeepRunning())
+  {
+    const NeighborhoodIterator::NeighborMask neighbors =
+      NeighborhoodIterator::GetNeighborsWithValue<VConnectivity>(image.GetPointer(), queryPixel, searchValue);
+    totalSize = NeighborhoodIterator::CountNeighbors(neighbors);
+    DoNotOptimize(totalSize);
+    NextQueryPixel(queryPixel, imageSize);
+  }
+  state.SetChecksum(totalSize);
+}
+
+/** Every pixel of the image, including the border, is a query; the checksum is the number of matching neighbors
+ *  of all of them. */
+void WholeImageGet8NeighborsWithValueFastCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * sizeof(ImageType::PixelType));
+
+  size_t totalSize = 0;
+  while(state.KeepRunning())
+  {
+    totalSize = 0;
+    itk::ImageRegionConstIteratorWithIndex<ImageType> imageIterator(image, image->GetLargestPossibleRegion());
+    while(!imageIterator.IsAtEnd())
+    {
+      totalSize += NeighborhoodIterator::Get8NeighborsWithValueFast(imageIterator.GetIndex(), image.GetPointer(),
+                                                                    searchValue).size();
+      ++imageIterator;
+    }
+    DoNotOptimize(totalSize);
+  }
+  state.SetChecksum(totalSize);
+}
+
+size_t CountNeighbors(const NeighborhoodIterator::NeighborMaskImageType* const masks)
+{
+  size_t totalSize = 0;
+  const std::uint8_t* const buffer = masks->GetBufferPointer();
+  for(size_t i = 0; i < masks->GetBufferedRegion().GetNumberOfPixels(); ++i)
+  {
+    totalSize += NeighborhoodIterator::CountNeighbors(buffer[i]);
+  }
+  return totalSize;
+}
+
+template <bool TParallel>
+void WholeImageNeighborMasksCase(BenchmarkState& state)
+{
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * (sizeof(ImageType::PixelType) + sizeof(std::uint8_t)));
+
+  NeighborhoodIterator::NeighborMaskImageType::Pointer masks = NeighborhoodIterator::NeighborMaskImageType::New();
+  ThreadPool pool(TParallel ? state.GetNumberOfThreads() : 1);
+  while(state.KeepRunning())
+  {
+    if(TParallel)
+    {
+      NeighborhoodIterator::Compute8NeighborMasksParallel(image.GetPointer(), searchValue, masks.GetPointer(), pool);
+    }
+    else
+    {
+      NeighborhoodIterator::Compute8NeighborMasks(image.GetPointer(), searchValue, masks.GetPointer());
+    }
+    DoNotOptimize(masks->GetBufferPointer());
+    ClobberMemory();
+  }
+  state.SetChecksum(CountNeighbors(masks.GetPointer()));
+}
+
+} // end anonymous namespace
+
+void RegisterNeighborhoodIteratorBenchmarks(BenchmarkRegistry& registry)
+{
+  registry.Add("NeighborhoodIterator/Get8NeighborsWithValue", Get8NeighborsWithValueCase, 10);
+  registry.Add("NeighborhoodIterator/Get8NeighborsWithValueFast", Get8NeighborsWithValueFastCase, 10);
+  registry.Add("NeighborhoodIterator/Get8NeighborsWithValueRowSpans", Get8NeighborsWithValueRowSpansCase, 10);
+  registry.Add("NeighborhoodIterator/Fixed/4Neighbors/2D", GetNeighborsWithValueFixedCase<ImageType, 4>, 10);
+  registry.Add("NeighborhoodIterator/Fixed/8Neighbors/2D", GetNeighborsWithValueFixedCase<ImageType, 8>, 10);
+  registry.Add("NeighborhoodIterator/Fixed/6Neighbors/3D", GetNeighborsWithValueFixedCase<Image3DType, 6>, 10);
+  registry.Add("NeighborhoodIterator/Fixed/18Neighbors/3D", GetNeighborsWithValueFixedCase<Image3DType, 18>, 10);
+  registry.Add("NeighborhoodIterator/Fixed/26Neighbors/3D", GetNeighborsWithValueFixedCase<Image3DType, 26>, 10);
+
+  registry.Add("NeighborhoodIterator/WholeImage/Get8NeighborsWithValueFast", WholeImageGet8NeighborsWithValueFastCase,
+               1000);
+  registry.Add("NeighborhoodIterator/WholeImage/NeighborMasks", WholeImageNeighborMasksCase<false>, 1000);
+  registry.AddMultiThreaded("NeighborhoodIterator/WholeImage/NeighborMasksParallel", WholeImageNeighborMasksCase<true>,
+                            1000);
+}
@@ -0,0 +1,154 @@
+#include "PatchDistance.h"
+
+// STL
+#include <cmath>
+#include <stdexcept>
+
+#if defined(PATCHDISTANCE_HAVE_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace PatchDistance
+{
+
+float SumOfAbsoluteDifferencesScalar(const float* a, const std::ptrdiff_t strideA,
+                                     const float* b, const std::ptrdiff_t strideB,
+                                     const std::size_t width, const std::size_t height)
+{
+  float difference = 0.0f;
+  for(std::size_t row = 0; row < height; ++row, a += strideA, b += strideB)
+  {
+    for(std::size_t column = 0; column < width; ++column)
+    {
+      difference += std::fabs(a[column] - b[column]);
+    }
+  }
+  return difference;
+}
+
+float SumOfSquaredDifferencesScalar(const float* a, const std::ptrdiff_t strideA,
+                                    const float* b, const std::ptrdiff_t strideB,
+                                    const std::size_t width, const std::size_t height)
+{
+  float difference = 0.0f;
+  for(std::size_t row = 0; row < height; ++row, a += strideA, b += strideB)
+  {
+    for(std::size_t column = 0; column < width; ++column)
+    {
+      const float pixelDifference = a[column] - b[column];
+      difference += pixelDifference * pixelDifference;
+    }
+  }
+  return difference;
+}
+
+const char* GetMetricName(const Metric metric)
+{
+  return metric == SumOfAbsoluteDifferences ? "SAD" : "SSD";
+}
+
+const char* GetInstructionSetName(const InstructionSet instructionSet)
+{
+  switch(instructionSet)
+  {
+    case SSE:
+      return "SSE";
+    case AVX2:
+      return "AVX2";
+    default:
+      return "Scalar";
+  }
+}
+
+#if defined(PATCHDISTANCE_HAVE_X86)
+static bool CPUSupportsSSE2()
+{
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+  return true; // Part of x86-64, or already required by the flags of the whole build
+#elif defined(_MSC_VER)
+  int registers[4];
+  __cpuid(registers, 1);
+  return (registers[3] & (1 << 26)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool CPUSupportsAVX2()
+{
+#if defined(_MSC_VER)
+  int registers[4];
+  __cpuid(registers, 1);
+  const bool osSavesYMM = (registers[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+  const bool fma = (registers[2] & (1 << 12)) != 0;
+  const bool f16c = (registers[2] & (1 << 29)) != 0;
+  __cpuidex(registers, 7, 0);
+  const bool avx2 = (registers[1] & (1 << 5)) != 0;
+  return osSavesYMM && fma && f16c && avx2;
+#else
+  // Also checks that the OS saves the YMM registers
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") && __builtin_cpu_supports("f16c");
+#endif
+}
+#endif
+
+bool IsInstructionSetSupported(const InstructionSet instructionSet)
+{
+  switch(instructionSet)
+  {
+    case Scalar:
+      return true;
+#if defined(PATCHDISTANCE_HAVE_X86)
+    case SSE:
+    {
+      static const bool supported = CPUSupportsSSE2();
+      return supported;
+    }
+    case AVX2:
+    {
+      static const bool supported = CPUSupportsAVX2();
+      return supported;
+    }
+#endif
+    default:
+      return false;
+  }
+}
+
+InstructionSet GetBestInstructionSet()
+{
+  static const InstructionSet best =
+    IsInstructionSetSupported(AVX2) ? AVX2 : (IsInstructionSetSupported(SSE) ? SSE : Scalar);
+  return best;
+}
+
+PatchDistanceFunction GetPatchDistanceFunction(const Metric metric, const InstructionSet instructionSet)
+{
+  if(!IsInstructionSetSupported(instructionSet))
+  {
+    throw std::runtime_error(std::string("Patch distance kernels for ") + GetInstructionSetName(instructionSet) +
+                             " are not supported on this CPU or in this build!");
+  }
+
+  const bool absolute = metric == SumOfAbsoluteDifferences;
+  switch(instructionSet)
+  {
+#if defined(PATCHDISTANCE_HAVE_X86)
+    case SSE:
+      return absolute ? SumOfAbsoluteDifferencesSSE : SumOfSquaredDifferencesSSE;
+    case AVX2:
+      return absolute ? SumOfAbsoluteDifferencesAVX2 : SumOfSquaredDifferencesAVX2;
+#endif
+    default:
+      return absolute ? SumOfAbsoluteDifferencesScalar : SumOfSquaredDifferencesScalar;
+  }
+}
+
+PatchDistanceFunction GetPatchDistanceFunction(const Metric metric)
+{
+  return GetPatchDistanceFunction(metric, GetBestInstructionSet());
+}
+
+} // end namespace PatchDistance
@@ -0,0 +1,108 @@
+/**
+ * Demo: Compute the distance (SAD or SSD) between two patches of a float image directly on the image
+ *       buffer, a row pointer and a stride at a time, with SSE and AVX2 kernels chosen at runtime,
+ *       and compare it to the iterator based Difference() of ImageRegionDifferenceVsVector.
+ *
+ *       The kernels work on raw buffers (PatchDistanceKernels.h): a patch is the pointer to its first
+ *       pixel, its width and height, and the distance in pixels between the starts of two rows (the
+ *       width of the buffered region). The SSE and AVX2 kernels are compiled in their own translation
+ *       units with the flags for their instruction set and are only called if the CPU supports it.
+ *
+ *       ComputeBoundedDistance() gives up on a patch once its partial distance exceeds a bound, the early
+ *       exit that ConditionalVsFull measures, applied to best match searches (see PatchSearch.h).
+ */
+
+#ifndef PatchDistance_h
+#define PatchDistance_h
+
+#include "PatchDistanceKernels.h"
+
+// ITK
+#include "itkImage.h"
+
+// STL
+#include <algorithm>
+
+namespace PatchDistance
+{
+
+typedef itk::Image<float, 2> ImageType;
+
+enum Metric
+{
+  SumOfAbsoluteDifferences,
+  SumOfSquaredDifferences
+};
+
+enum InstructionSet
+{
+  Scalar,
+  SSE,
+  AVX2 // With FMA and F16C, which every AVX2 CPU has
+};
+
+/** "SAD" or "SSD" */
+const char* GetMetricName(const Metric metric);
+
+/** "Scalar", "SSE" or "AVX2" */
+const char* GetInstructionSetName(const InstructionSet instructionSet);
+
+/** True if this build has kernels for 'instructionSet' and the CPU (and OS) can run them. */
+bool IsInstructionSetSupported(const InstructionSet instructionSet);
+
+/** The widest supported instruction set; detected once. */
+InstructionSet GetBestInstructionSet();
+
+/** The kernel for 'metric' using 'instructionSet', which must be supported. */
+PatchDistanceFunction GetPatchDistanceFunction(const Metric metric, const InstructionSet instructionSet);
+
+/** The kernel for 'metric' using the best supported instruction set. */
+PatchDistanceFunction GetPatchDistanceFunction(const Metric metric);
+
+/** The distance between the patches 'a' and 'b' of 'image'. Both regions must have the same size
+ *  and be inside the buffered region; this is not checked. */
+inline float ComputeDistance(const ImageType* const image, const itk::ImageRegion<2>& a, const itk::ImageRegion<2>& b,
+                             PatchDistanceFunction distanceFunction)
+{
+  const float* const buffer = image->GetBufferPointer();
+  const std::ptrdiff_t stride = image->GetBufferedRegion().GetSize()[0];
+
+  return distanceFunction(buffer + image->ComputeOffset(a.GetIndex()), stride,
+                          buffer + image->ComputeOffset(b.GetIndex()), stride,
+                          a.GetSize()[0], a.GetSize()[1]);
+}
+
+inline float ComputeDistance(const ImageType* const image, const itk::ImageRegion<2>& a, const itk::ImageRegion<2>& b,
+                             const Metric metric)
+{
+  return ComputeDistance(image, a, b, GetPatchDistanceFunction(metric));
+}
+
+/** The number of rows ComputeBoundedDistance() sums between two comparisons with the bound: often enough to
+ *  stop early, rarely enough that the horizontal sum of each block is cheap next to the block itself. */
+const std::size_t rowsPerBoundCheck = 4;
+
+/** The distance between two patches given as for a PatchDistanceFunction, computed a block of rows at a time,
+ *  stopping as soon as the partial distance exceeds 'bound' (e.g. the distance to the best match so far).
+ *  Returns the partial distance, which is > bound if it stopped early, and sets numberOfRows to the number
+ *  of rows it summed. The sum of the blocks can differ from the one-call distance in the last bits. */
+inline float ComputeBoundedDistance(const float* a, const std::ptrdiff_t strideA,
+                                    const float* b, const std::ptrdiff_t strideB,
+                                    const std::size_t width, const std::size_t height,
+                                    PatchDistanceFunction distanceFunction, const float bound,
+                                    std::size_t& numberOfRows)
+{
+  float distance = 0.0f;
+  for(numberOfRows = 0; numberOfRows < height && distance <= bound; numberOfRows += rowsPerBoundCheck)
+  {
+    const std::size_t blockHeight = std::min(rowsPerBoundCheck, height - numberOfRows);
+    distance += distanceFunction(a + numberOfRows * strideA, strideA, b + numberOfRows * strideB, strideB,
+                                 width, blockHeight);
+  }
+  numberOfRows = std::min(numberOfRows, height);
+  return distance;
+}
+
+} // end namespace PatchDistance
+
+#endif
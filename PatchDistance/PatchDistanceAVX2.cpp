@@ -0,0 +1,241 @@
+// Compiled with -mavx2 -mfma -mf16c (see CMakeLists.txt), and only called if the CPU supports all three.
+// Only PatchDistanceKernels.h may be included from this project.
+#include "PatchDistanceKernels.h"
+
+#include <immintrin.h>
+
+namespace PatchDistance
+{
+
+/** The sum of the eight lanes of 'sum'. */
+static inline float HorizontalSum(const __m256 sum)
+{
+  __m128 quad = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  __m128 pairs = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+  return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+/** A mask loading the first 'count' (< 8) lanes, so the end of each row is loaded with a masked load
+ *  instead of a scalar loop (patch widths are odd, e.g. 21 = 8 + 8 + 5). */
+static inline __m256i GetTailMask(const std::size_t count)
+{
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(count)), lanes);
+}
+
+float SumOfAbsoluteDifferencesAVX2(const float* a, const std::ptrdiff_t strideA,
+                                   const float* b, const std::ptrdiff_t strideB,
+                                   const std::size_t width, const std::size_t height)
+{
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  const std::size_t vectorWidth = width - width % 8;
+  const __m256i tailMask = GetTailMask(width % 8);
+
+  // Two accumulators, so consecutive additions don't wait for each other
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+
+  for(std::size_t row = 0; row < height; ++row, a += strideA, b += strideB)
+  {
+    std::size_t column = 0;
+    for(; column + 16 <= vectorWidth; column += 16)
+    {
+      const __m256 difference0 = _mm256_sub_ps(_mm256_loadu_ps(a + column), _mm256_loadu_ps(b + column));
+      const __m256 difference1 = _mm256_sub_ps(_mm256_loadu_ps(a + column + 8), _mm256_loadu_ps(b + column + 8));
+      sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(signMask, difference0));
+      sum1 = _mm256_add_ps(sum1, _mm256_andnot_ps(signMask, difference1));
+    }
+    for(; column < vectorWidth; column += 8)
+    {
+      const __m256 difference = _mm256_sub_ps(_mm256_loadu_ps(a + column), _mm256_loadu_ps(b + column));
+      sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(signMask, difference));
+    }
+    if(column < width)
+    {
+      // Masked lanes load as 0 in both, so they add |0 - 0|
+      const __m256 difference = _mm256_sub_ps(_mm256_maskload_ps(a + column, tailMask),
+                                              _mm256_maskload_ps(b + column, tailMask));
+      sum1 = _mm256_add_ps(sum1, _mm256_andnot_ps(signMask, difference));
+    }
+  }
+
+  return HorizontalSum(_mm256_add_ps(sum0, sum1));
+}
+
+float SumOfSquaredDifferencesAVX2(const float* a, const std::ptrdiff_t strideA,
+                                  const float* b, const std::ptrdiff_t strideB,
+                                  const std::size_t width, const std::size_t height)
+{
+  const std::size_t vectorWidth = width - width % 8;
+  const __m256i tailMask = GetTailMask(width % 8);
+
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+
+  for(std::size_t row = 0; row < height; ++row, a += strideA, b += strideB)
+  {
+    std::size_t column = 0;
+    for(; column + 16 <= vectorWidth; column += 16)
+    {
+      const __m256 difference0 = _mm256_sub_ps(_mm256_loadu_ps(a + column), _mm256_loadu_ps(b + column));
+      const __m256 difference1 = _mm256_sub_ps(_mm256_loadu_ps(a + column + 8), _mm256_loadu_ps(b + column + 8));
+      sum0 = _mm256_fmadd_ps(difference0, difference0, sum0);
+      sum1 = _mm256_fmadd_ps(difference1, difference1, sum1);
+    }
+    for(; column < vectorWidth; column += 8)
+    {
+      const __m256 difference = _mm256_sub_ps(_mm256_loadu_ps(a + column), _mm256_loadu_ps(b + column));
+      sum0 = _mm256_fmadd_ps(difference, difference, sum0);
+    }
+    if(column < width)
+    {
+      const __m256 difference = _mm256_sub_ps(_mm256_maskload_ps(a + column, tailMask),
+                                              _mm256_maskload_ps(b + column, tailMask));
+      sum1 = _mm256_fmadd_ps(difference, difference, sum1);
+    }
+  }
+
+  return HorizontalSum(_mm256_add_ps(sum0, sum1));
+}
+
+/** The sum of the eight 32 bit lanes of 'sum', modulo 2^32. */
+static inline std::uint32_t HorizontalSum(const __m256i sum)
+{
+  __m128i quad = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+  __m128i pairs = _mm_add_epi32(quad, _mm_shuffle_epi32(quad, _MM_SHUFFLE(1, 0, 3, 2)));
+  return static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_add_epi32(pairs, _mm_shuffle_epi32(pairs, _MM_SHUFFLE(2, 3, 0, 1)))));
+}
+
+std::uint32_t SumOfAbsoluteDifferencesUInt8AVX2(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length)
+{
+  // vpsadbw sums the absolute differences of 8 bytes into each 64 bit lane
+  __m256i sum = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for(; i + 32 <= length; i += 32)
+  {
+    const __m256i codesA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const __m256i codesB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    sum = _mm256_add_epi64(sum, _mm256_sad_epu8(codesA, codesB));
+  }
+  __m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+  if(i + 16 <= length)
+  {
+    const __m128i codesA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i codesB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    sum128 = _mm_add_epi64(sum128, _mm_sad_epu8(codesA, codesB));
+    i += 16;
+  }
+
+  std::uint32_t total = static_cast<std::uint32_t>(_mm_cvtsi128_si32(sum128) + _mm_cvtsi128_si32(_mm_srli_si128(sum128, 8)));
+  for(; i < length; ++i)
+  {
+    total += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+  }
+  return total;
+}
+
+std::uint32_t SumOfSquaredDifferencesUInt8AVX2(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length)
+{
+  // Widen 16 codes at a time to 16 bits; vpmaddwd squares the differences and adds pairs of them into 32 bits
+  __m256i sum0 = _mm256_setzero_si256();
+  __m256i sum1 = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for(; i + 32 <= length; i += 32)
+  {
+    const __m256i difference0 =
+      _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i))),
+                       _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+    const __m256i difference1 =
+      _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i + 16))),
+                       _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i + 16))));
+    sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(difference0, difference0));
+    sum1 = _mm256_add_epi32(sum1, _mm256_madd_epi16(difference1, difference1));
+  }
+  if(i + 16 <= length)
+  {
+    const __m256i difference =
+      _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i))),
+                       _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+    sum0 = _mm256_add_epi32(sum0, _mm256_madd_epi16(difference, difference));
+    i += 16;
+  }
+
+  std::uint32_t total = HorizontalSum(_mm256_add_epi32(sum0, sum1));
+  for(; i < length; ++i)
+  {
+    const int difference = static_cast<int>(a[i]) - static_cast<int>(b[i]);
+    total += difference * difference;
+  }
+  return total;
+}
+
+/** The differences of 8 half floats of 'a' and 'b', widened to floats with F16C. */
+static inline __m256 LoadHalfDifference(const std::uint16_t* a, const std::uint16_t* b)
+{
+  return _mm256_sub_ps(_mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a))),
+                       _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b))));
+}
+
+/** The last (< 8) halves, padded with zeros in both, which add nothing to either distance. */
+static inline __m256 LoadHalfDifferenceTail(const std::uint16_t* a, const std::uint16_t* b, const std::size_t count)
+{
+  std::uint16_t tailA[8] = {0};
+  std::uint16_t tailB[8] = {0};
+  for(std::size_t i = 0; i < count; ++i)
+  {
+    tailA[i] = a[i];
+    tailB[i] = b[i];
+  }
+  return LoadHalfDifference(tailA, tailB);
+}
+
+float SumOfAbsoluteDifferencesHalfAVX2(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length)
+{
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  std::size_t i = 0;
+  for(; i + 16 <= length; i += 16)
+  {
+    sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(signMask, LoadHalfDifference(a + i, b + i)));
+    sum1 = _mm256_add_ps(sum1, _mm256_andnot_ps(signMask, LoadHalfDifference(a + i + 8, b + i + 8)));
+  }
+  if(i + 8 <= length)
+  {
+    sum0 = _mm256_add_ps(sum0, _mm256_andnot_ps(signMask, LoadHalfDifference(a + i, b + i)));
+    i += 8;
+  }
+  if(i < length)
+  {
+    sum1 = _mm256_add_ps(sum1, _mm256_andnot_ps(signMask, LoadHalfDifferenceTail(a + i, b + i, length - i)));
+  }
+  return HorizontalSum(_mm256_add_ps(sum0, sum1));
+}
+
+float SumOfSquaredDifferencesHalfAVX2(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length)
+{
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  std::size_t i = 0;
+  for(; i + 16 <= length; i += 16)
+  {
+    const __m256 difference0 = LoadHalfDifference(a + i, b + i);
+    const __m256 difference1 = LoadHalfDifference(a + i + 8, b + i + 8);
+    sum0 = _mm256_fmadd_ps(difference0, difference0, sum0);
+    sum1 = _mm256_fmadd_ps(difference1, difference1, sum1);
+  }
+  if(i + 8 <= length)
+  {
+    const __m256 difference = LoadHalfDifference(a + i, b + i);
+    sum0 = _mm256_fmadd_ps(difference, difference, sum0);
+    i += 8;
+  }
+  if(i < length)
+  {
+    const __m256 difference = LoadHalfDifferenceTail(a + i, b + i, length - i);
+    sum1 = _mm256_fmadd_ps(difference, difference, sum1);
+  }
+  return HorizontalSum(_mm256_add_ps(sum0, sum1));
+}
+
+} // end namespace PatchDistance
@@ -0,0 +1,407 @@
+#include "PatchDistance.h"
+#include "PatchSearch.h"
+#include "QuantizedDescriptors.h"
+
+// The same image and patches as ImageRegionDifferenceVsVector, so the results compare directly
+#include "ImageRegionDifferenceVsVector.h"
+
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+template <PatchDistance::Metric TMetric, PatchDistance::InstructionSet TInstructionSet>
+void PatchDistanceCase(BenchmarkState& state)
+{
+  using namespace ImageRegionDifferenceVsVector;
+
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  itk::Index<2> center = {{imageSize/2, imageSize/2}};
+  itk::ImageRegion<2> centerRegion = GetRegionInRadiusAroundPixel(center, patchRadius);
+
+  std::vector<itk::ImageRegion<2> > allRegions = GetAllValidRegions(image, patchRadius);
+  state.SetItemsPerIteration(allRegions.size()); // patch comparisons
+  state.SetBytesPerIteration(2.0 * allRegions.size() * centerRegion.GetNumberOfPixels() * sizeof(float));
+
+  PatchDistance::PatchDistanceFunction distanceFunction =
+    PatchDistance::GetPatchDistanceFunction(TMetric, TInstructionSet);
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+  {
+    totalDifference = 0.0f;
+    for(size_t regionId = 0; regionId < allRegions.size(); ++regionId)
+    {
+      totalDifference += PatchDistance::ComputeDistance(image, allRegions[regionId], centerRegion, distanceFunction);
+    }
+    DoNotOptimize(totalDifference);
+  }
+  state.SetChecksum(totalDifference);
+}
+
+/** Register the SAD and SSD cases of 'instructionSet', if this CPU can run them. */
+template <PatchDistance::InstructionSet TInstructionSet>
+void RegisterInstructionSet(BenchmarkRegistry& registry)
+{
+  if(!PatchDistance::IsInstructionSetSupported(TInstructionSet))
+  {
+    return;
+  }
+
+  const std::string instructionSetName = PatchDistance::GetInstructionSetName(TInstructionSet);
+  registry.Add("PatchDistance/SAD/" + instructionSetName,
+               PatchDistanceCase<PatchDistance::SumOfAbsoluteDifferences, TInstructionSet>);
+  registry.Add("PatchDistance/SSD/" + instructionSetName,
+               PatchDistanceCase<PatchDistance::SumOfSquaredDifferences, TInstructionSet>);
+}
+
+/** A 256x256 image with texture, so that no two patches are alike. */
+PatchDistance::ImageType::Pointer CreateSearchImage()
+{
+  PatchDistance::ImageType::Pointer image = PatchDistance::ImageType::New();
+
+  itk::Index<2> corner = {{0,0}};
+  itk::Size<2> size = {{256, 256}};
+  image->SetRegions(itk::ImageRegion<2>(corner, size));
+  image->Allocate();
+
+  float* const buffer = image->GetBufferPointer();
+  for(itk::SizeValueType y = 0; y < size[1]; ++y)
+  {
+    for(itk::SizeValueType x = 0; x < size[0]; ++x)
+    {
+      buffer[y * size[0] + x] = static_cast<float>((x * 31 + y * 17 + x * y) % 256);
+    }
+  }
+  return image;
+}
+
+/** A 256x256 image of smooth waves with a little noise, like a natural image: a few patches are close to
+ *  the query and most are far from it. */
+PatchDistance::ImageType::Pointer CreateSmoothSearchImage()
+{
+  PatchDistance::ImageType::Pointer image = PatchDistance::ImageType::New();
+
+  itk::Index<2> corner = {{0,0}};
+  itk::Size<2> size = {{256, 256}};
+  image->SetRegions(itk::ImageRegion<2>(corner, size));
+  image->Allocate();
+
+  float* const buffer = image->GetBufferPointer();
+  unsigned int noise = 1;
+  for(itk::SizeValueType y = 0; y < size[1]; ++y)
+  {
+    for(itk::SizeValueType x = 0; x < size[0]; ++x)
+    {
+      noise = noise * 1103515245u + 12345u;
+      buffer[y * size[0] + x] = static_cast<float>(128 + 60 * std::sin(0.1 * x) + 50 * std::cos(0.07 * y + 0.02 * x) +
+                                                   (noise >> 16) % 8);
+    }
+  }
+  return image;
+}
+
+/** The query is the patch at the center of the image. */
+itk::ImageRegion<2> GetSearchQuery(const PatchDistance::ImageType* const image, const unsigned int patchRadius)
+{
+  const itk::Size<2> imageSize = image->GetBufferedRegion().GetSize();
+  itk::Index<2> center = {{static_cast<itk::IndexValueType>(imageSize[0]/2),
+                           static_cast<itk::IndexValueType>(imageSize[1]/2)}};
+  return ImageRegionDifferenceVsVector::GetRegionInRadiusAroundPixel(center, patchRadius);
+}
+
+double SumDistances(const std::vector<float>& distances)
+{
+  double sum = 0;
+  for(size_t i = 0; i < distances.size(); ++i)
+  {
+    sum += distances[i];
+  }
+  return sum;
+}
+
+/** The descriptors of every patch of ImageRegionDifferenceVsVector's image, and the one of its center patch. */
+void MakeDescriptors(PatchDistance::DescriptorMatrix& descriptors, std::vector<float>& query)
+{
+  using namespace ImageRegionDifferenceVsVector;
+
+  ImageType::Pointer image = ImageType::New();
+  CreateImage(image);
+
+  itk::Index<2> center = {{imageSize/2, imageSize/2}};
+  query = MakeDescriptor(GetRegionInRadiusAroundPixel(center, patchRadius), image);
+
+  MakeDescriptorMatrix(GetAllValidRegions(image, patchRadius), image, descriptors);
+}
+
+template <typename TComponent>
+void SetDescriptorScanSize(BenchmarkState& state,
+                           const ImageRegionDifferenceVsVector::PackedDescriptorMatrix<TComponent>& descriptors)
+{
+  state.SetItemsPerIteration(descriptors.GetNumberOfDescriptors()); // descriptor comparisons
+  state.SetBytesPerIteration(static_cast<double>(descriptors.GetNumberOfDescriptors()) * descriptors.GetStride() *
+                             sizeof(TComponent));
+}
+
+/** How far the distances computed from quantized descriptors are from the float ones. */
+void SetQuantizationError(BenchmarkState& state, const PatchDistance::Metric metric,
+                          const std::vector<float>& quantizedDifferences)
+{
+  PatchDistance::DescriptorMatrix descriptors;
+  std::vector<float> query;
+  MakeDescriptors(descriptors, query);
+
+  std::vector<float> differences;
+  PatchDistance::ComputeDifferences(&query[0], descriptors, metric, PatchDistance::Scalar, differences);
+
+  double relativeErrorSum = 0;
+  double maximumRelativeError = 0;
+  size_t numberOfNonZeroDifferences = 0;
+  for(size_t i = 0; i < differences.size(); ++i)
+  {
+    if(differences[i] > 0)
+    {
+      const double relativeError = std::fabs(quantizedDifferences[i] - differences[i]) / differences[i];
+      relativeErrorSum += relativeError;
+      maximumRelativeError = std::max(maximumRelativeError, relativeError);
+      ++numberOfNonZeroDifferences;
+    }
+  }
+  state.SetCounter("mean_relative_error",
+                   numberOfNonZeroDifferences > 0 ? relativeErrorSum / numberOfNonZeroDifferences : 0);
+  state.SetCounter("max_relative_error", maximumRelativeError);
+}
+
+template <PatchDistance::Metric TMetric, PatchDistance::InstructionSet TInstructionSet>
+void FloatDescriptorCase(BenchmarkState& state)
+{
+  PatchDistance::DescriptorMatrix descriptors;
+  std::vector<float> query;
+  MakeDescriptors(descriptors, query);
+  SetDescriptorScanSize(state, descriptors);
+
+  std::vector<float> differences;
+  while(state.KeepRunning())
+  {
+    PatchDistance::ComputeDifferences(&query[0], descriptors, TMetric, TInstructionSet, differences);
+    DoNotOptimize(differences.data());
+    ClobberMemory();
+  }
+  state.SetChecksum(SumDistances(differences));
+}
+
+template <PatchDistance::Metric TMetric, PatchDistance::InstructionSet TInstructionSet>
+void UInt8DescriptorCase(BenchmarkState& state)
+{
+  PatchDistance::DescriptorMatrix floatDescriptors;
+  std::vector<float> floatQuery;
+  MakeDescriptors(floatDescriptors, floatQuery);
+
+  PatchDistance::UInt8Quantization quantization = PatchDistance::ComputeUInt8Quantization(floatDescriptors);
+  PatchDistance::UInt8DescriptorMatrix descriptors;
+  PatchDistance::Quantize(floatDescriptors, quantization, descriptors);
+  std::vector<std::uint8_t> query(floatQuery.size());
+  PatchDistance::Quantize(&floatQuery[0], floatQuery.size(), quantization, &query[0]);
+  SetDescriptorScanSize(state, descriptors);
+
+  std::vector<float> differences;
+  while(state.KeepRunning())
+  {
+    PatchDistance::ComputeDifferences(&query[0], descriptors, quantization, TMetric, TInstructionSet, differences);
+    DoNotOptimize(differences.data());
+    ClobberMemory();
+  }
+  state.SetChecksum(SumDistances(differences));
+  SetQuantizationError(state, TMetric, differences);
+}
+
+template <PatchDistance::Metric TMetric, PatchDistance::InstructionSet TInstructionSet>
+void HalfDescriptorCase(BenchmarkState& state)
+{
+  PatchDistance::DescriptorMatrix floatDescriptors;
+  std::vector<float> floatQuery;
+  MakeDescriptors(floatDescriptors, floatQuery);
+
+  PatchDistance::HalfDescriptorMatrix descriptors;
+  PatchDistance::ConvertToHalf(floatDescriptors, descriptors);
+  std::vector<std::uint16_t> query(floatQuery.size());
+  PatchDistance::ConvertToHalf(&floatQuery[0], floatQuery.size(), &query[0]);
+  SetDescriptorScanSize(state, descriptors);
+
+  std::vector<float> differences;
+  while(state.KeepRunning())
+  {
+    PatchDistance::ComputeDifferences(&query[0], descriptors, TMetric, TInstructionSet, differences);
+    DoNotOptimize(differences.data());
+    ClobberMemory();
+  }
+  state.SetChecksum(SumDistances(differences));
+  SetQuantizationError(state, TMetric, differences);
+}
+
+/** Register the float, uint8 and half descriptor scans of 'instructionSet', if this CPU can run them. */
+template <PatchDistance::InstructionSet TInstructionSet>
+void RegisterDescriptorInstructionSet(BenchmarkRegistry& registry)
+{
+  if(!PatchDistance::IsInstructionSetSupported(TInstructionSet))
+  {
+    return;
+  }
+
+  const std::string instructionSetName = PatchDistance::GetInstructionSetName(TInstructionSet);
+  registry.Add("PatchDistance/Descriptors/Float/SAD/" + instructionSetName,
+               FloatDescriptorCase<PatchDistance::SumOfAbsoluteDifferences, TInstructionSet>);
+  registry.Add("PatchDistance/Descriptors/Float/SSD/" + instructionSetName,
+               FloatDescriptorCase<PatchDistance::SumOfSquaredDifferences, TInstructionSet>);
+  registry.Add("PatchDistance/Descriptors/UInt8/SAD/" + instructionSetName,
+               UInt8DescriptorCase<PatchDistance::SumOfAbsoluteDifferences, TInstructionSet>);
+  registry.Add("PatchDistance/Descriptors/UInt8/SSD/" + instructionSetName,
+               UInt8DescriptorCase<PatchDistance::SumOfSquaredDifferences, TInstructionSet>);
+  registry.Add("PatchDistance/Descriptors/Half/SAD/" + instructionSetName,
+               HalfDescriptorCase<PatchDistance::SumOfAbsoluteDifferences, TInstructionSet>);
+  registry.Add("PatchDistance/Descriptors/Half/SSD/" + instructionSetName,
+               HalfDescriptorCase<PatchDistance::SumOfSquaredDifferences, TInstructionSet>);
+}
+
+template <unsigned int TPatchRadius>
+void ExhaustiveSearchCase(BenchmarkState& state)
+{
+  PatchDistance::ImageType::Pointer image = CreateSearchImage();
+  itk::ImageRegion<2> query = GetSearchQuery(image, TPatchRadius);
+
+  const itk::Size<2> searchSize = PatchDistance::GetSearchSize(image, query.GetSize());
+  state.SetItemsPerIteration(searchSize[0] * searchSize[1]); // candidate patches
+
+  PatchDistance::PatchDistanceFunction distanceFunction =
+    PatchDistance::GetPatchDistanceFunction(PatchDistance::SumOfSquaredDifferences);
+
+  std::vector<float> distances;
+  while(state.KeepRunning())
+  {
+    PatchDistance::ComputeDistancesToAllPatches(image, query, distanceFunction, distances);
+    DoNotOptimize(distances.data());
+    ClobberMemory();
+  }
+  state.SetChecksum(SumDistances(distances));
+}
+
+/** The exhaustive search on state.GetNumberOfThreads() threads; the distances are the same as on one. */
+template <unsigned int TPatchRadius>
+void ParallelExhaustiveSearchCase(BenchmarkState& state)
+{
+  PatchDistance::ImageType::Pointer image = CreateSearchImage();
+  itk::ImageRegion<2> query = GetSearchQuery(image, TPatchRadius);
+
+  const itk::Size<2> searchSize = PatchDistance::GetSearchSize(image, query.GetSize());
+  state.SetItemsPerIteration(searchSize[0] * searchSize[1]); // candidate patches
+
+  PatchDistance::PatchDistanceFunction distanceFunction =
+    PatchDistance::GetPatchDistanceFunction(PatchDistance::SumOfSquaredDifferences);
+
+  ThreadPool pool(state.GetNumberOfThreads());
+
+  std::vector<float> distances;
+  while(state.KeepRunning())
+  {
+    PatchDistance::ComputeDistancesToAllPatches(image, query, distanceFunction, distances, pool);
+    DoNotOptimize(distances.data());
+    ClobberMemory();
+  }
+  state.SetChecksum(SumDistances(distances));
+}
+
+/** The best match of the query among all the patches of the textured or smooth search image, comparing every
+ *  candidate in full or abandoning it once it is further than the best so far. Reports the fraction of patch
+ *  rows skipped. */
+template <PatchDistance::Metric TMetric, bool TEarlyTermination, bool TSmoothImage, unsigned int TPatchRadius>
+void BestMatchCase(BenchmarkState& state)
+{
+  PatchDistance::ImageType::Pointer image = TSmoothImage ? CreateSmoothSearchImage() : CreateSearchImage();
+  itk::ImageRegion<2> query = GetSearchQuery(image, TPatchRadius);
+
+  const itk::Size<2> searchSize = PatchDistance::GetSearchSize(image, query.GetSize());
+  state.SetItemsPerIteration(searchSize[0] * searchSize[1]); // candidate patches
+
+  PatchDistance::PatchDistanceFunction distanceFunction = PatchDistance::GetPatchDistanceFunction(TMetric);
+
+  PatchDistance::BestMatch bestMatch;
+  while(state.KeepRunning())
+  {
+    bestMatch = TEarlyTermination ? PatchDistance::FindBestMatch(image, query, distanceFunction) :
+                                    PatchDistance::FindBestMatchExhaustively(image, query, distanceFunction);
+    DoNotOptimize(bestMatch);
+  }
+  state.SetChecksum(bestMatch.Distance);
+  state.SetCounter("pruned_fraction", 1.0 - static_cast<double>(bestMatch.NumberOfRowsComputed) / bestMatch.NumberOfRows);
+}
+
+template <unsigned int TPatchRadius>
+void FFTSearchCase(BenchmarkState& state)
+{
+  PatchDistance::ImageType::Pointer image = CreateSearchImage();
+  itk::ImageRegion<2> query = GetSearchQuery(image, TPatchRadius);
+
+  const itk::Size<2> searchSize = PatchDistance::GetSearchSize(image, query.GetSize());
+  state.SetItemsPerIteration(searchSize[0] * searchSize[1]); // candidate patches
+
+  // The image tables are computed once per image, not per query
+  PatchDistance::FFTSumOfSquaredDifferencesSearch search(image);
+
+  std::vector<float> distances;
+  while(state.KeepRunning())
+  {
+    search.Search(query, distances);
+    DoNotOptimize(distances.data());
+    ClobberMemory();
+  }
+  state.SetChecksum(SumDistances(distances));
+}
+
+} // end anonymous namespace
+
+void RegisterPatchDistanceBenchmarks(BenchmarkRegistry& registry)
+{
+  // PatchDistance/SAD computes the same as ImageRegionDifferenceVsVector/ITKImage
+  RegisterInstructionSet<PatchDistance::Scalar>(registry);
+  RegisterInstructionSet<PatchDistance::SSE>(registry);
+  RegisterInstructionSet<PatchDistance::AVX2>(registry);
+
+  // The center descriptor against every descriptor of the same image, stored as floats, uint8 codes or halves
+  RegisterDescriptorInstructionSet<PatchDistance::Scalar>(registry);
+  RegisterDescriptorInstructionSet<PatchDistance::SSE>(registry);
+  RegisterDescriptorInstructionSet<PatchDistance::AVX2>(registry);
+
+  // SSD from one query to every patch of a 256x256 image. The exhaustive search uses the best instruction set.
+  registry.Add("PatchDistance/SSDSearch/Exhaustive/Radius10", ExhaustiveSearchCase<10>);
+  registry.Add("PatchDistance/SSDSearch/FFT/Radius10", FFTSearchCase<10>);
+  registry.Add("PatchDistance/SSDSearch/Exhaustive/Radius25", ExhaustiveSearchCase<25>);
+  registry.Add("PatchDistance/SSDSearch/FFT/Radius25", FFTSearchCase<25>);
+
+  // The single best match of the same query, in the textured image and in a smooth one
+  registry.Add("PatchDistance/BestMatch/SAD/Full/Textured/Radius10",
+               BestMatchCase<PatchDistance::SumOfAbsoluteDifferences, false, false, 10>);
+  registry.Add("PatchDistance/BestMatch/SAD/EarlyTermination/Textured/Radius10",
+               BestMatchCase<PatchDistance::SumOfAbsoluteDifferences, true, false, 10>);
+  registry.Add("PatchDistance/BestMatch/SSD/Full/Textured/Radius10",
+               BestMatchCase<PatchDistance::SumOfSquaredDifferences, false, false, 10>);
+  registry.Add("PatchDistance/BestMatch/SSD/EarlyTermination/Textured/Radius10",
+               BestMatchCase<PatchDistance::SumOfSquaredDifferences, true, false, 10>);
+  registry.Add("PatchDistance/BestMatch/SSD/Full/Smooth/Radius10",
+               BestMatchCase<PatchDistance::SumOfSquaredDifferences, false, true, 10>);
+  registry.Add("PatchDistance/BestMatch/SSD/EarlyTermination/Smooth/Radius10",
+               BestMatchCase<PatchDistance::SumOfSquaredDifferences, true, true, 10>);
+  registry.Add("PatchDistance/BestMatch/SSD/Full/Smooth/Radius25",
+               BestMatchCase<PatchDistance::SumOfSquaredDifferences, false, true, 25>);
+  registry.Add("PatchDistance/BestMatch/SSD/EarlyTermination/Smooth/Radius25",
+               BestMatchCase<PatchDistance::SumOfSquaredDifferences, true, true, 25>);
+
+  registry.AddMultiThreaded("PatchDistance/SSDSearch/ExhaustiveParallel/Radius10", ParallelExhaustiveSearchCase<10>);
+  registry.AddMultiThreaded("PatchDistance/SSDSearch/ExhaustiveParallel/Radius25", ParallelExhaustiveSearchCase<25>);
+}
@@ -0,0 +1,75 @@
+/**
+ * Patch distance kernels on raw float buffers, one set per instruction set.
+ *
+ * The quantized descriptor kernels compare two descriptors of 'length' components, stored as uint8 codes
+ * or as IEEE half floats (see QuantizedDescriptors.h), widening them on the fly. The uint8 kernels return
+ * the exact integer distance between the codes, which must fit in 32 bits: up to 66051 components for SSD.
+ *
+ * This header is included by the SSE and AVX2 translation units, which are compiled with the flags for
+ * their instruction set, so it must not define any inline function or template: the linker could pick
+ * the AVX2 compiled copy for callers that run on CPUs without AVX2.
+ */
+
+#ifndef PatchDistanceKernels_h
+#define PatchDistanceKernels_h
+
+// STL
+#include <cstddef>
+#include <cstdint>
+
+namespace PatchDistance
+{
+
+/** 'a' and 'b' point to the first pixel of each patch; 'strideA' and 'strideB' are the number of
+ *  pixels from the start of one row to the start of the next. */
+typedef float (*PatchDistanceFunction)(const float* a, const std::ptrdiff_t strideA,
+                                       const float* b, const std::ptrdiff_t strideB,
+                                       const std::size_t width, const std::size_t height);
+
+typedef std::uint32_t (*UInt8DescriptorDistanceFunction)(const std::uint8_t* a, const std::uint8_t* b,
+                                                         const std::size_t length);
+
+typedef float (*HalfDescriptorDistanceFunction)(const std::uint16_t* a, const std::uint16_t* b,
+                                                const std::size_t length);
+
+float SumOfAbsoluteDifferencesScalar(const float* a, const std::ptrdiff_t strideA,
+                                     const float* b, const std::ptrdiff_t strideB,
+                                     const std::size_t width, const std::size_t height);
+float SumOfSquaredDifferencesScalar(const float* a, const std::ptrdiff_t strideA,
+                                    const float* b, const std::ptrdiff_t strideB,
+                                    const std::size_t width, const std::size_t height);
+
+std::uint32_t SumOfAbsoluteDifferencesUInt8Scalar(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length);
+std::uint32_t SumOfSquaredDifferencesUInt8Scalar(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length);
+float SumOfAbsoluteDifferencesHalfScalar(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length);
+float SumOfSquaredDifferencesHalfScalar(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length);
+
+#if defined(PATCHDISTANCE_HAVE_X86)
+float SumOfAbsoluteDifferencesSSE(const float* a, const std::ptrdiff_t strideA,
+                                  const float* b, const std::ptrdiff_t strideB,
+                                  const std::size_t width, const std::size_t height);
+float SumOfSquaredDifferencesSSE(const float* a, const std::ptrdiff_t strideA,
+                                 const float* b, const std::ptrdiff_t strideB,
+                                 const std::size_t width, const std::size_t height);
+
+std::uint32_t SumOfAbsoluteDifferencesUInt8SSE(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length);
+std::uint32_t SumOfSquaredDifferencesUInt8SSE(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length);
+float SumOfAbsoluteDifferencesHalfSSE(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length);
+float SumOfSquaredDifferencesHalfSSE(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length);
+
+float SumOfAbsoluteDifferencesAVX2(const float* a, const std::ptrdiff_t strideA,
+                                   const float* b, const std::ptrdiff_t strideB,
+                                   const std::size_t width, const std::size_t height);
+float SumOfSquaredDifferencesAVX2(const float* a, const std::ptrdiff_t strideA,
+                                  const float* b, const std::ptrdiff_t strideB,
+                                  const std::size_t width, const std::size_t height);
+
+std::uint32_t SumOfAbsoluteDifferencesUInt8AVX2(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length);
+std::uint32_t SumOfSquaredDifferencesUInt8AVX2(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length);
+float SumOfAbsoluteDifferencesHalfAVX2(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length);
+float SumOfSquaredDifferencesHalfAVX2(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length);
+#endif
+
+} // end namespace PatchDistance
+
+#endif
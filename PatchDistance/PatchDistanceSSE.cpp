@@ -0,0 +1,206 @@
+// Compiled with -msse2 (see CMakeLists.txt). Only PatchDistanceKernels.h may be included from this project.
+#include "PatchDistanceKernels.h"
+
+#include <emmintrin.h>
+
+namespace PatchDistance
+{
+
+/** The sum of the four lanes of 'sum'. */
+static inline float HorizontalSum(const __m128 sum)
+{
+  __m128 pairs = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, 1)));
+}
+
+float SumOfAbsoluteDifferencesSSE(const float* a, const std::ptrdiff_t strideA,
+                                  const float* b, const std::ptrdiff_t strideB,
+                                  const std::size_t width, const std::size_t height)
+{
+  // |x| is x without its sign bit
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+
+  __m128 sum = _mm_setzero_ps();
+  float tailSum = 0.0f;
+  const std::size_t vectorWidth = width - width % 4;
+
+  for(std::size_t row = 0; row < height; ++row, a += strideA, b += strideB)
+  {
+    std::size_t column = 0;
+    for(; column < vectorWidth; column += 4)
+    {
+      const __m128 difference = _mm_sub_ps(_mm_loadu_ps(a + column), _mm_loadu_ps(b + column));
+      sum = _mm_add_ps(sum, _mm_andnot_ps(signMask, difference));
+    }
+    for(; column < width; ++column)
+    {
+      const float difference = a[column] - b[column];
+      tailSum += difference < 0 ? -difference : difference;
+    }
+  }
+
+  return HorizontalSum(sum) + tailSum;
+}
+
+float SumOfSquaredDifferencesSSE(const float* a, const std::ptrdiff_t strideA,
+                                 const float* b, const std::ptrdiff_t strideB,
+                                 const std::size_t width, const std::size_t height)
+{
+  __m128 sum = _mm_setzero_ps();
+  float tailSum = 0.0f;
+  const std::size_t vectorWidth = width - width % 4;
+
+  for(std::size_t row = 0; row < height; ++row, a += strideA, b += strideB)
+  {
+    std::size_t column = 0;
+    for(; column < vectorWidth; column += 4)
+    {
+      const __m128 difference = _mm_sub_ps(_mm_loadu_ps(a + column), _mm_loadu_ps(b + column));
+      sum = _mm_add_ps(sum, _mm_mul_ps(difference, difference));
+    }
+    for(; column < width; ++column)
+    {
+      const float difference = a[column] - b[column];
+      tailSum += difference * difference;
+    }
+  }
+
+  return HorizontalSum(sum) + tailSum;
+}
+
+/** The sum of the four 32 bit lanes of 'sum', modulo 2^32. */
+static inline std::uint32_t HorizontalSum(const __m128i sum)
+{
+  const __m128i pairs = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  return static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_add_epi32(pairs, _mm_shuffle_epi32(pairs, _MM_SHUFFLE(2, 3, 0, 1)))));
+}
+
+std::uint32_t SumOfAbsoluteDifferencesUInt8SSE(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length)
+{
+  // psadbw sums the absolute differences of 8 bytes into each 64 bit half
+  __m128i sum = _mm_setzero_si128();
+  std::size_t i = 0;
+  for(; i + 16 <= length; i += 16)
+  {
+    const __m128i codesA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i codesB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    sum = _mm_add_epi64(sum, _mm_sad_epu8(codesA, codesB));
+  }
+
+  std::uint32_t total = static_cast<std::uint32_t>(_mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+  for(; i < length; ++i)
+  {
+    total += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+  }
+  return total;
+}
+
+std::uint32_t SumOfSquaredDifferencesUInt8SSE(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length)
+{
+  // Widen to 16 bits; pmaddwd squares the differences and adds pairs of them into 32 bits
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum = _mm_setzero_si128();
+  std::size_t i = 0;
+  for(; i + 16 <= length; i += 16)
+  {
+    const __m128i codesA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i codesB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    const __m128i differenceLow = _mm_sub_epi16(_mm_unpacklo_epi8(codesA, zero), _mm_unpacklo_epi8(codesB, zero));
+    const __m128i differenceHigh = _mm_sub_epi16(_mm_unpackhi_epi8(codesA, zero), _mm_unpackhi_epi8(codesB, zero));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(differenceLow, differenceLow));
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(differenceHigh, differenceHigh));
+  }
+
+  std::uint32_t total = HorizontalSum(sum);
+  for(; i < length; ++i)
+  {
+    const int difference = static_cast<int>(a[i]) - static_cast<int>(b[i]);
+    total += difference * difference;
+  }
+  return total;
+}
+
+/** Converts the half floats in the low 16 bits of each lane to floats, with SSE2 only (F16C came with AVX).
+ *  Shifting the exponent and mantissa into place and multiplying by 2^112 rebiases the exponent, and also
+ *  gives the right value for subnormal halves; infinities and NaNs get the float's all ones exponent. */
+static inline __m128 HalfToFloat(const __m128i halves)
+{
+  const __m128i exponentAndMantissa = _mm_and_si128(halves, _mm_set1_epi32(0x7fff));
+  const __m128i sign = _mm_slli_epi32(_mm_xor_si128(halves, exponentAndMantissa), 16);
+
+  const __m128 scaled = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exponentAndMantissa, 13)),
+                                   _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+  const __m128i infinityOrNaN = _mm_and_si128(_mm_cmpgt_epi32(exponentAndMantissa, _mm_set1_epi32(0x7bff)),
+                                              _mm_set1_epi32(255 << 23));
+
+  return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, infinityOrNaN)));
+}
+
+/** Calls accumulate(difference) for each group of four differences (as floats) of 'a' and 'b'. The last
+ *  group is padded with zeros in both, which add nothing to either distance. */
+template <typename TAccumulate>
+static inline void ForEachHalfDifference(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length,
+                                         TAccumulate& accumulate)
+{
+  const __m128i zero = _mm_setzero_si128();
+  std::size_t i = 0;
+  for(; i + 8 <= length; i += 8)
+  {
+    const __m128i halvesA = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+    const __m128i halvesB = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+    accumulate(_mm_sub_ps(HalfToFloat(_mm_unpacklo_epi16(halvesA, zero)), HalfToFloat(_mm_unpacklo_epi16(halvesB, zero))));
+    accumulate(_mm_sub_ps(HalfToFloat(_mm_unpackhi_epi16(halvesA, zero)), HalfToFloat(_mm_unpackhi_epi16(halvesB, zero))));
+  }
+  if(i < length)
+  {
+    std::uint16_t tailA[8] = {0};
+    std::uint16_t tailB[8] = {0};
+    for(std::size_t tail = 0; i + tail < length; ++tail)
+    {
+      tailA[tail] = a[i + tail];
+      tailB[tail] = b[i + tail];
+    }
+    ForEachHalfDifference(tailA, tailB, 8, accumulate);
+  }
+}
+
+namespace
+{
+
+struct AbsoluteDifferenceSum
+{
+  AbsoluteDifferenceSum() : m_Sum(_mm_setzero_ps()) {}
+  void operator()(const __m128 difference)
+  {
+    m_Sum = _mm_add_ps(m_Sum, _mm_andnot_ps(_mm_set1_ps(-0.0f), difference));
+  }
+  __m128 m_Sum;
+};
+
+struct SquaredDifferenceSum
+{
+  SquaredDifferenceSum() : m_Sum(_mm_setzero_ps()) {}
+  void operator()(const __m128 difference)
+  {
+    m_Sum = _mm_add_ps(m_Sum, _mm_mul_ps(difference, difference));
+  }
+  __m128 m_Sum;
+};
+
+} // end anonymous namespace
+
+float SumOfAbsoluteDifferencesHalfSSE(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length)
+{
+  AbsoluteDifferenceSum sum;
+  ForEachHalfDifference(a, b, length, sum);
+  return HorizontalSum(sum.m_Sum);
+}
+
+float SumOfSquaredDifferencesHalfSSE(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length)
+{
+  SquaredDifferenceSum sum;
+  ForEachHalfDifference(a, b, length, sum);
+  return HorizontalSum(sum.m_Sum);
+}
+
+} // end namespace PatchDistance
@@ -0,0 +1,336 @@
+#include "PatchSearch.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace PatchDistance
+{
+
+namespace
+{
+
+typedef std::complex<double> ComplexType;
+
+itk::SizeValueType NextPowerOfTwo(const itk::SizeValueType value)
+{
+  itk::SizeValueType powerOfTwo = 1;
+  while(powerOfTwo < value)
+  {
+    powerOfTwo *= 2;
+  }
+  return powerOfTwo;
+}
+
+/** In-place iterative radix-2 FFT of 'data', whose size must be a power of two. Not normalized. */
+void FFT(ComplexType* const data, const size_t size, const bool inverse)
+{
+  // Bit reversal permutation
+  for(size_t i = 1, j = 0; i < size; ++i)
+  {
+    size_t bit = size >> 1;
+    for(; j & bit; bit >>= 1)
+    {
+      j ^= bit;
+    }
+    j ^= bit;
+    if(i < j)
+    {
+      std::swap(data[i], data[j]);
+    }
+  }
+
+  const double pi = 3.14159265358979323846;
+  for(size_t length = 2; length <= size; length *= 2)
+  {
+    const double angle = (inverse ? 2 : -2) * pi / length;
+    const ComplexType rootOfUnity(std::cos(angle), std::sin(angle));
+    for(size_t start = 0; start < size; start += length)
+    {
+      ComplexType twiddle(1, 0);
+      for(size_t k = 0; k < length / 2; ++k)
+      {
+        const ComplexType even = data[start + k];
+        const ComplexType odd = data[start + k + length / 2] * twiddle;
+        data[start + k] = even + odd;
+        data[start + k + length / 2] = even - odd;
+        twiddle *= rootOfUnity;
+      }
+    }
+  }
+}
+
+/** Transform rows [0, numberOfRows) of a width x height array. */
+void TransformRows(std::vector<ComplexType>& data, const size_t width, const size_t numberOfRows, const bool inverse)
+{
+  for(size_t row = 0; row < numberOfRows; ++row)
+  {
+    FFT(&data[row * width], width, inverse);
+  }
+}
+
+/** Transform every column of a width x height array, through a contiguous copy of each. */
+void TransformColumns(std::vector<ComplexType>& data, const size_t width, const size_t height, const bool inverse)
+{
+  std::vector<ComplexType> column(height);
+  for(size_t x = 0; x < width; ++x)
+  {
+    for(size_t y = 0; y < height; ++y)
+    {
+      column[y] = data[y * width + x];
+    }
+    FFT(&column[0], height, inverse);
+    for(size_t y = 0; y < height; ++y)
+    {
+      data[y * width + x] = column[y];
+    }
+  }
+}
+
+/** The sum of squares of the pixels in the patch with corner (x, y), from the summed-area table. */
+inline double GetPatchSquaredSum(const std::vector<double>& table, const size_t tableWidth,
+                                 const size_t x, const size_t y, const size_t patchWidth, const size_t patchHeight)
+{
+  return table[(y + patchHeight) * tableWidth + x + patchWidth] - table[y * tableWidth + x + patchWidth] -
+         table[(y + patchHeight) * tableWidth + x] + table[y * tableWidth + x];
+}
+
+/** The distances to the candidates with corners in rows [beginRow, endRow). */
+void ComputeDistancesInRows(const ImageType* const image, const itk::ImageRegion<2>& query,
+                            PatchDistanceFunction distanceFunction, const itk::Size<2>& searchSize,
+                            const itk::SizeValueType beginRow, const itk::SizeValueType endRow, float* const distances)
+{
+  const itk::Size<2> patchSize = query.GetSize();
+
+  const float* const buffer = image->GetBufferPointer();
+  const std::ptrdiff_t stride = image->GetBufferedRegion().GetSize()[0];
+  const float* const queryPointer = buffer + image->ComputeOffset(query.GetIndex());
+
+  for(itk::SizeValueType y = beginRow; y < endRow; ++y)
+  {
+    const float* candidate = buffer + y * stride;
+    float* const distanceRow = distances + y * searchSize[0];
+    for(itk::SizeValueType x = 0; x < searchSize[0]; ++x)
+    {
+      distanceRow[x] = distanceFunction(queryPointer, stride, candidate + x, stride, patchSize[0], patchSize[1]);
+    }
+  }
+}
+
+/** The best match search of FindBestMatch() and FindBestMatchExhaustively(), with the distance computed by
+ *  computeDistance(query, candidate, stride, patchSize, bestDistance, numberOfRows). */
+template <typename TComputeDistance>
+BestMatch SearchBestMatch(const ImageType* const image, const itk::ImageRegion<2>& query,
+                          const TComputeDistance& computeDistance)
+{
+  const itk::Size<2> patchSize = query.GetSize();
+  const itk::Size<2> searchSize = GetSearchSize(image, patchSize);
+
+  const float* const buffer = image->GetBufferPointer();
+  const std::ptrdiff_t stride = image->GetBufferedRegion().GetSize()[0];
+  const std::ptrdiff_t queryOffset = image->ComputeOffset(query.GetIndex());
+
+  BestMatch bestMatch;
+  bestMatch.Distance = std::numeric_limits<float>::max();
+  bestMatch.NumberOfRowsComputed = 0;
+  bestMatch.NumberOfRows = 0;
+
+  itk::Index<2> bestCorner = query.GetIndex();
+  for(itk::SizeValueType y = 0; y < searchSize[1]; ++y)
+  {
+    for(itk::SizeValueType x = 0; x < searchSize[0]; ++x)
+    {
+      const std::ptrdiff_t candidateOffset = y * stride + x;
+      if(candidateOffset == queryOffset)
+      {
+        continue;
+      }
+
+      size_t numberOfRows;
+      const float distance = computeDistance(buffer + queryOffset, buffer + candidateOffset, stride, patchSize,
+                                             bestMatch.Distance, numberOfRows);
+      bestMatch.NumberOfRowsComputed += numberOfRows;
+      bestMatch.NumberOfRows += patchSize[1];
+      if(distance < bestMatch.Distance)
+      {
+        bestMatch.Distance = distance;
+        bestCorner = image->GetBufferedRegion().GetIndex();
+        bestCorner[0] += x;
+        bestCorner[1] += y;
+      }
+    }
+  }
+
+  bestMatch.Region = itk::ImageRegion<2>(bestCorner, patchSize);
+  return bestMatch;
+}
+
+} // end anonymous namespace
+
+itk::Size<2> GetSearchSize(const ImageType* const image, const itk::Size<2>& patchSize)
+{
+  const itk::Size<2> imageSize = image->GetBufferedRegion().GetSize();
+
+  itk::Size<2> searchSize;
+  for(unsigned int dimension = 0; dimension < 2; ++dimension)
+  {
+    searchSize[dimension] = imageSize[dimension] >= patchSize[dimension] ? imageSize[dimension] - patchSize[dimension] + 1 : 0;
+  }
+  return searchSize;
+}
+
+void ComputeDistancesToAllPatches(const ImageType* const image, const itk::ImageRegion<2>& query,
+                                  PatchDistanceFunction distanceFunction, std::vector<float>& distances)
+{
+  const itk::Size<2> searchSize = GetSearchSize(image, query.GetSize());
+  distances.resize(searchSize[0] * searchSize[1]);
+  if(distances.empty())
+  {
+    return;
+  }
+
+  ComputeDistancesInRows(image, query, distanceFunction, searchSize, 0, searchSize[1], &distances[0]);
+}
+
+void ComputeDistancesToAllPatches(const ImageType* const image, const itk::ImageRegion<2>& query,
+                                  PatchDistanceFunction distanceFunction, std::vector<float>& distances,
+                                  ThreadPool& pool)
+{
+  const itk::Size<2> searchSize = GetSearchSize(image, query.GetSize());
+  distances.resize(searchSize[0] * searchSize[1]);
+  if(distances.empty())
+  {
+    return;
+  }
+
+  // A few chunks per thread, so a thread that was descheduled doesn't hold up the others
+  const itk::SizeValueType numberOfChunks =
+    std::min<itk::SizeValueType>(searchSize[1], 4 * pool.GetNumberOfThreads());
+  float* const distancesPointer = &distances[0];
+  pool.ParallelFor(numberOfChunks, [&](const size_t chunkId)
+  {
+    ComputeDistancesInRows(image, query, distanceFunction, searchSize,
+                           chunkId * searchSize[1] / numberOfChunks, (chunkId + 1) * searchSize[1] / numberOfChunks,
+                           distancesPointer);
+  });
+}
+
+BestMatch FindBestMatchExhaustively(const ImageType* const image, const itk::ImageRegion<2>& query,
+                                    PatchDistanceFunction distanceFunction)
+{
+  return SearchBestMatch(image, query, [=](const float* const queryPointer, const float* const candidate,
+                                           const std::ptrdiff_t stride, const itk::Size<2>& patchSize,
+                                           const float, size_t& numberOfRows)
+  {
+    numberOfRows = patchSize[1];
+    return distanceFunction(queryPointer, stride, candidate, stride, patchSize[0], patchSize[1]);
+  });
+}
+
+BestMatch FindBestMatch(const ImageType* const image, const itk::ImageRegion<2>& query,
+                        PatchDistanceFunction distanceFunction)
+{
+  return SearchBestMatch(image, query, [=](const float* const queryPointer, const float* const candidate,
+                                           const std::ptrdiff_t stride, const itk::Size<2>& patchSize,
+                                           const float bestDistance, size_t& numberOfRows)
+  {
+    // Only a candidate strictly closer than the best replaces it, so stop as soon as it can't be
+    return ComputeBoundedDistance(queryPointer, stride, candidate, stride, patchSize[0], patchSize[1],
+                                  distanceFunction, std::nextafter(bestDistance, 0.0f), numberOfRows);
+  });
+}
+
+FFTSumOfSquaredDifferencesSearch::FFTSumOfSquaredDifferencesSearch(const ImageType* const image) :
+  m_Image(image), m_ImageSize(image->GetBufferedRegion().GetSize())
+{
+  const size_t width = m_ImageSize[0];
+  const size_t height = m_ImageSize[1];
+  const float* const buffer = image->GetBufferPointer();
+
+  m_SquaredSumTable.assign((width + 1) * (height + 1), 0.0);
+  for(size_t y = 0; y < height; ++y)
+  {
+    double rowSum = 0;
+    for(size_t x = 0; x < width; ++x)
+    {
+      const double pixel = buffer[y * width + x];
+      rowSum += pixel * pixel;
+      m_SquaredSumTable[(y + 1) * (width + 1) + x + 1] = m_SquaredSumTable[y * (width + 1) + x + 1] + rowSum;
+    }
+  }
+
+  m_TransformSize[0] = NextPowerOfTwo(width);
+  m_TransformSize[1] = NextPowerOfTwo(height);
+
+  m_ImageTransform.assign(m_TransformSize[0] * m_TransformSize[1], ComplexType(0, 0));
+  for(size_t y = 0; y < height; ++y)
+  {
+    for(size_t x = 0; x < width; ++x)
+    {
+      m_ImageTransform[y * m_TransformSize[0] + x] = buffer[y * width + x];
+    }
+  }
+  // The padding rows are all zero, so they are zero after the row transforms too
+  TransformRows(m_ImageTransform, m_TransformSize[0], height, false);
+  TransformColumns(m_ImageTransform, m_TransformSize[0], m_TransformSize[1], false);
+}
+
+void FFTSumOfSquaredDifferencesSearch::Search(const itk::ImageRegion<2>& query, std::vector<float>& distances) const
+{
+  const itk::Size<2> patchSize = query.GetSize();
+  const itk::Size<2> searchSize = GetSearchSize(m_Image, patchSize);
+  distances.resize(searchSize[0] * searchSize[1]);
+
+  const size_t imageWidth = m_ImageSize[0];
+  const size_t tableWidth = imageWidth + 1;
+  const size_t transformWidth = m_TransformSize[0];
+  const size_t transformHeight = m_TransformSize[1];
+
+  const size_t patchWidth = patchSize[0];
+  const size_t patchHeight = patchSize[1];
+
+  const itk::Index<2> queryCorner = query.GetIndex();
+  const itk::Index<2> bufferCorner = m_Image->GetBufferedRegion().GetIndex();
+  const size_t queryX = queryCorner[0] - bufferCorner[0];
+  const size_t queryY = queryCorner[1] - bufferCorner[1];
+  const double querySquaredSum =
+    GetPatchSquaredSum(m_SquaredSumTable, tableWidth, queryX, queryY, patchWidth, patchHeight);
+
+  // The query, zero padded to the transform size
+  const float* const buffer = m_Image->GetBufferPointer();
+  m_QueryTransform.assign(transformWidth * transformHeight, ComplexType(0, 0));
+  for(size_t y = 0; y < patchHeight; ++y)
+  {
+    for(size_t x = 0; x < patchWidth; ++x)
+    {
+      m_QueryTransform[y * transformWidth + x] = buffer[(queryY + y) * imageWidth + queryX + x];
+    }
+  }
+  TransformRows(m_QueryTransform, transformWidth, patchHeight, false);
+  TransformColumns(m_QueryTransform, transformWidth, transformHeight, false);
+
+  // Cross-correlation: the inverse transform of image * conj(query). Only the rows of valid candidates are needed,
+  // so the columns are transformed first and then just those rows.
+  for(size_t i = 0; i < m_QueryTransform.size(); ++i)
+  {
+    m_QueryTransform[i] = m_ImageTransform[i] * std::conj(m_QueryTransform[i]);
+  }
+  TransformColumns(m_QueryTransform, transformWidth, transformHeight, true);
+  TransformRows(m_QueryTransform, transformWidth, searchSize[1], true);
+
+  const double normalization = 1.0 / (transformWidth * transformHeight);
+  for(size_t y = 0; y < searchSize[1]; ++y)
+  {
+    for(size_t x = 0; x < searchSize[0]; ++x)
+    {
+      const double crossCorrelation = m_QueryTransform[y * transformWidth + x].real() * normalization;
+      const double candidateSquaredSum =
+        GetPatchSquaredSum(m_SquaredSumTable, tableWidth, x, y, patchWidth, patchHeight);
+      const double distance = querySquaredSum + candidateSquaredSum - 2 * crossCorrelation;
+      distances[y * searchSize[0] + x] = static_cast<float>(std::max(distance, 0.0)); // Rounding can make 0 negative
+    }
+  }
+}
+
+} // end namespace PatchDistance
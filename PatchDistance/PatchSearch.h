@@ -0,0 +1,96 @@
+/**
+ * Exhaustive patch search: the distance from a query patch to the patch at every position of an image
+ * where it fits entirely.
+ *
+ * ComputeDistancesToAllPatches() compares the query to each candidate with a patch distance kernel,
+ * which costs (2r+1)^2 per candidate. Given a ThreadPool, the candidate rows are split across its threads;
+ * every distance is computed exactly as in the single-threaded version, so the results are identical.
+ *
+ * FFTSumOfSquaredDifferencesSearch computes the SSD to every candidate at once by expanding
+ *   SSD(a, b) = sum(a^2) + sum(b^2) - 2 sum(ab)
+ * sum(b^2) comes from a summed-area table of the squared image, and the cross term sum(ab) for all
+ * candidates is the cross-correlation of the image with the query, computed with FFTs. Both tables for
+ * the image are computed once, so a query costs one forward and one inverse FFT of the (padded) image
+ * size, nearly independent of the patch radius.
+ *
+ * FindBestMatch() only needs the closest candidate, so it passes the distance to the best candidate so far
+ * as the bound of ComputeBoundedDistance(), and abandons most candidates after their first few rows.
+ *
+ * Distances are stored row-major by the position of the candidate's corner: distance[y * width + x] is
+ * for the candidate at (x, y) relative to the buffered region, and GetSearchSize() gives width x height.
+ * This is the order of ImageRegionDifferenceVsVector::GetAllValidRegions().
+ */
+
+#ifndef PatchSearch_h
+#define PatchSearch_h
+
+#include "PatchDistance.h"
+#include "ThreadPool.h"
+
+// STL
+#include <complex>
+#include <vector>
+
+namespace PatchDistance
+{
+
+/** The number of positions along each dimension at which a patch of 'patchSize' fits in the image. */
+itk::Size<2> GetSearchSize(const ImageType* const image, const itk::Size<2>& patchSize);
+
+void ComputeDistancesToAllPatches(const ImageType* const image, const itk::ImageRegion<2>& query,
+                                  PatchDistanceFunction distanceFunction, std::vector<float>& distances);
+
+void ComputeDistancesToAllPatches(const ImageType* const image, const itk::ImageRegion<2>& query,
+                                  PatchDistanceFunction distanceFunction, std::vector<float>& distances,
+                                  ThreadPool& pool);
+
+struct BestMatch
+{
+  /** The closest candidate other than the query itself, and its distance. */
+  itk::ImageRegion<2> Region;
+  float Distance;
+
+  /** The patch rows compared, out of the rows of all the candidates compared in full. */
+  std::size_t NumberOfRowsComputed;
+  std::size_t NumberOfRows;
+};
+
+/** The candidate closest to 'query' (which is not a candidate), comparing every candidate in full. */
+BestMatch FindBestMatchExhaustively(const ImageType* const image, const itk::ImageRegion<2>& query,
+                                    PatchDistanceFunction distanceFunction);
+
+/** The same, abandoning each candidate once it is further than the best so far. Candidates are visited in
+ *  row-major order, and ties go to the first, so both find the same match unless two distances differ
+ *  only by rounding. */
+BestMatch FindBestMatch(const ImageType* const image, const itk::ImageRegion<2>& query,
+                        PatchDistanceFunction distanceFunction);
+
+class FFTSumOfSquaredDifferencesSearch
+{
+public:
+  /** Computes the summed-area table and the FFT of 'image', which must stay alive and unmodified. */
+  explicit FFTSumOfSquaredDifferencesSearch(const ImageType* const image);
+
+  /** The SSD from the patch 'query' (inside the image) to every candidate patch of the same size. */
+  void Search(const itk::ImageRegion<2>& query, std::vector<float>& distances) const;
+
+private:
+  typedef std::complex<double> ComplexType;
+
+  const ImageType* m_Image;
+  itk::Size<2> m_ImageSize;
+
+  /** The image is zero padded to a power of two along each dimension. */
+  itk::Size<2> m_TransformSize;
+  std::vector<ComplexType> m_ImageTransform;
+
+  /** (width + 1) x (height + 1); entry (x, y) is the sum of squares of the pixels above and left of (x, y). */
+  std::vector<double> m_SquaredSumTable;
+
+  /** Scratch space for the query transform (Search() is const, but not thread safe). */
+  mutable std::vector<ComplexType> m_QueryTransform;
+};
+
+} // end namespace PatchDistance
+
+#endif
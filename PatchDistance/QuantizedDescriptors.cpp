@@ -0,0 +1,264 @@
+#include "QuantizedDescriptors.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace PatchDistance
+{
+
+std::uint32_t SumOfAbsoluteDifferencesUInt8Scalar(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length)
+{
+  std::uint32_t difference = 0;
+  for(std::size_t i = 0; i < length; ++i)
+  {
+    difference += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+  }
+  return difference;
+}
+
+std::uint32_t SumOfSquaredDifferencesUInt8Scalar(const std::uint8_t* a, const std::uint8_t* b, const std::size_t length)
+{
+  std::uint32_t difference = 0;
+  for(std::size_t i = 0; i < length; ++i)
+  {
+    const int codeDifference = static_cast<int>(a[i]) - static_cast<int>(b[i]);
+    difference += codeDifference * codeDifference;
+  }
+  return difference;
+}
+
+float SumOfAbsoluteDifferencesHalfScalar(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length)
+{
+  float difference = 0.0f;
+  for(std::size_t i = 0; i < length; ++i)
+  {
+    difference += std::fabs(HalfToFloat(a[i]) - HalfToFloat(b[i]));
+  }
+  return difference;
+}
+
+float SumOfSquaredDifferencesHalfScalar(const std::uint16_t* a, const std::uint16_t* b, const std::size_t length)
+{
+  float difference = 0.0f;
+  for(std::size_t i = 0; i < length; ++i)
+  {
+    const float componentDifference = HalfToFloat(a[i]) - HalfToFloat(b[i]);
+    difference += componentDifference * componentDifference;
+  }
+  return difference;
+}
+
+UInt8Quantization ComputeUInt8Quantization(const DescriptorMatrix& descriptors)
+{
+  float minimum = std::numeric_limits<float>::max();
+  float maximum = -std::numeric_limits<float>::max();
+  for(size_t descriptorId = 0; descriptorId < descriptors.GetNumberOfDescriptors(); ++descriptorId)
+  {
+    const float* const descriptor = descriptors.GetDescriptor(descriptorId);
+    for(size_t i = 0; i < descriptors.GetDescriptorLength(); ++i)
+    {
+      minimum = std::min(minimum, descriptor[i]);
+      maximum = std::max(maximum, descriptor[i]);
+    }
+  }
+
+  UInt8Quantization quantization;
+  quantization.Offset = minimum <= maximum ? minimum : 0.0f;
+  quantization.Scale = maximum > minimum ? (maximum - minimum) / 255.0f : 1.0f;
+  return quantization;
+}
+
+void Quantize(const float* const descriptor, const size_t length, const UInt8Quantization& quantization,
+              std::uint8_t* const codes)
+{
+  const float inverseScale = 1.0f / quantization.Scale;
+  for(size_t i = 0; i < length; ++i)
+  {
+    const float code = std::floor((descriptor[i] - quantization.Offset) * inverseScale + 0.5f);
+    codes[i] = static_cast<std::uint8_t>(std::min(std::max(code, 0.0f), 255.0f));
+  }
+}
+
+void Quantize(const DescriptorMatrix& descriptors, const UInt8Quantization& quantization,
+              UInt8DescriptorMatrix& quantized)
+{
+  quantized.SetSize(descriptors.GetNumberOfDescriptors(), descriptors.GetDescriptorLength());
+  for(size_t descriptorId = 0; descriptorId < descriptors.GetNumberOfDescriptors(); ++descriptorId)
+  {
+    Quantize(descriptors.GetDescriptor(descriptorId), descriptors.GetDescriptorLength(), quantization,
+             quantized.GetDescriptor(descriptorId));
+  }
+}
+
+std::uint16_t FloatToHalf(const float value)
+{
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  const std::uint16_t sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+  bits &= 0x7fffffff;
+
+  if(bits >= 0x7f800000) // Infinity or NaN (kept quiet)
+  {
+    return sign | 0x7c00 | (bits > 0x7f800000 ? 0x200 : 0);
+  }
+  if(bits >= 0x477ff000) // At least halfway between the largest half, 65504, and 65536: rounds to infinity
+  {
+    return sign | 0x7c00;
+  }
+  if(bits < 0x38800000) // Below the smallest normal half, 2^-14: a multiple of 2^-24
+  {
+    float magnitude;
+    std::memcpy(&magnitude, &bits, sizeof(magnitude));
+    return sign | static_cast<std::uint16_t>(std::nearbyint(magnitude * 16777216.0f)); // Rounds to nearest even
+  }
+
+  // Rebias the exponent and drop 13 mantissa bits, rounding to nearest even (a carry into the exponent is right)
+  std::uint32_t half = (bits - 0x38000000) >> 13;
+  const std::uint32_t remainder = bits & 0x1fff;
+  if(remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+  {
+    ++half;
+  }
+  return sign | static_cast<std::uint16_t>(half);
+}
+
+float HalfToFloat(const std::uint16_t half)
+{
+  const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000) << 16;
+  const std::uint32_t exponent = (half >> 10) & 0x1f;
+  const std::uint32_t mantissa = half & 0x3ff;
+
+  std::uint32_t bits;
+  if(exponent == 0) // Zero or subnormal: mantissa * 2^-24, exact in a float
+  {
+    const float magnitude = mantissa / 16777216.0f;
+    std::memcpy(&bits, &magnitude, sizeof(bits));
+    bits |= sign;
+  }
+  else if(exponent == 0x1f) // Infinity or NaN
+  {
+    bits = sign | 0x7f800000 | (mantissa << 13);
+  }
+  else
+  {
+    bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+  }
+
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void ConvertToHalf(const float* const descriptor, const size_t length, std::uint16_t* const halves)
+{
+  for(size_t i = 0; i < length; ++i)
+  {
+    halves[i] = FloatToHalf(descriptor[i]);
+  }
+}
+
+void ConvertToHalf(const DescriptorMatrix& descriptors, HalfDescriptorMatrix& converted)
+{
+  converted.SetSize(descriptors.GetNumberOfDescriptors(), descriptors.GetDescriptorLength());
+  for(size_t descriptorId = 0; descriptorId < descriptors.GetNumberOfDescriptors(); ++descriptorId)
+  {
+    ConvertToHalf(descriptors.GetDescriptor(descriptorId), descriptors.GetDescriptorLength(),
+                  converted.GetDescriptor(descriptorId));
+  }
+}
+
+static void CheckInstructionSet(const InstructionSet instructionSet)
+{
+  if(!IsInstructionSetSupported(instructionSet))
+  {
+    throw std::runtime_error(std::string("Descriptor distance kernels for ") + GetInstructionSetName(instructionSet) +
+                             " are not supported on this CPU or in this build!");
+  }
+}
+
+UInt8DescriptorDistanceFunction GetUInt8DescriptorDistanceFunction(const Metric metric,
+                                                                   const InstructionSet instructionSet)
+{
+  CheckInstructionSet(instructionSet);
+
+  const bool absolute = metric == SumOfAbsoluteDifferences;
+  switch(instructionSet)
+  {
+#if defined(PATCHDISTANCE_HAVE_X86)
+    case SSE:
+      return absolute ? SumOfAbsoluteDifferencesUInt8SSE : SumOfSquaredDifferencesUInt8SSE;
+    case AVX2:
+      return absolute ? SumOfAbsoluteDifferencesUInt8AVX2 : SumOfSquaredDifferencesUInt8AVX2;
+#endif
+    default:
+      return absolute ? SumOfAbsoluteDifferencesUInt8Scalar : SumOfSquaredDifferencesUInt8Scalar;
+  }
+}
+
+HalfDescriptorDistanceFunction GetHalfDescriptorDistanceFunction(const Metric metric,
+                                                                 const InstructionSet instructionSet)
+{
+  CheckInstructionSet(instructionSet);
+
+  const bool absolute = metric == SumOfAbsoluteDifferences;
+  switch(instructionSet)
+  {
+#if defined(PATCHDISTANCE_HAVE_X86)
+    case SSE:
+      return absolute ? SumOfAbsoluteDifferencesHalfSSE : SumOfSquaredDifferencesHalfSSE;
+    case AVX2:
+      return absolute ? SumOfAbsoluteDifferencesHalfAVX2 : SumOfSquaredDifferencesHalfAVX2;
+#endif
+    default:
+      return absolute ? SumOfAbsoluteDifferencesHalfScalar : SumOfSquaredDifferencesHalfScalar;
+  }
+}
+
+void ComputeDifferences(const float* const query, const DescriptorMatrix& descriptors, const Metric metric,
+                        const InstructionSet instructionSet, std::vector<float>& differences)
+{
+  // A descriptor is a patch of one row
+  PatchDistanceFunction distanceFunction = GetPatchDistanceFunction(metric, instructionSet);
+
+  differences.resize(descriptors.GetNumberOfDescriptors());
+  for(size_t descriptorId = 0; descriptorId < descriptors.GetNumberOfDescriptors(); ++descriptorId)
+  {
+    differences[descriptorId] = distanceFunction(query, 0, descriptors.GetDescriptor(descriptorId), 0,
+                                                 descriptors.GetDescriptorLength(), 1);
+  }
+}
+
+void ComputeDifferences(const std::uint8_t* const query, const UInt8DescriptorMatrix& descriptors,
+                        const UInt8Quantization& quantization, const Metric metric,
+                        const InstructionSet instructionSet, std::vector<float>& differences)
+{
+  UInt8DescriptorDistanceFunction distanceFunction = GetUInt8DescriptorDistanceFunction(metric, instructionSet);
+  const float scale = metric == SumOfAbsoluteDifferences ? quantization.Scale : quantization.Scale * quantization.Scale;
+
+  differences.resize(descriptors.GetNumberOfDescriptors());
+  for(size_t descriptorId = 0; descriptorId < descriptors.GetNumberOfDescriptors(); ++descriptorId)
+  {
+    differences[descriptorId] =
+      scale * distanceFunction(query, descriptors.GetDescriptor(descriptorId), descriptors.GetDescriptorLength());
+  }
+}
+
+void ComputeDifferences(const std::uint16_t* const query, const HalfDescriptorMatrix& descriptors, const Metric metric,
+                        const InstructionSet instructionSet, std::vector<float>& differences)
+{
+  HalfDescriptorDistanceFunction distanceFunction = GetHalfDescriptorDistanceFunction(metric, instructionSet);
+
+  differences.resize(descriptors.GetNumberOfDescriptors());
+  for(size_t descriptorId = 0; descriptorId < descriptors.GetNumberOfDescriptors(); ++descriptorId)
+  {
+    differences[descriptorId] =
+      distanceFunction(query, descriptors.GetDescriptor(descriptorId), descriptors.GetDescriptorLength());
+  }
+}
+
+} // end namespace PatchDistance
@@ -0,0 +1,263 @@
+#include "PatchMatch.h"
+#include "PatchSearch.h"
+
+#include "ImageRegionDifferenceVsVector.h"
+
+// STL
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace PatchMatch
+{
+
+namespace
+{
+
+/** The distance between the patches centered at 'a' and 'b'. */
+inline float ComputeDistance(const ImageType* const image, const unsigned int patchRadius,
+                             PatchDistance::PatchDistanceFunction distanceFunction,
+                             const itk::Index<2>& a, const itk::Index<2>& b)
+{
+  return PatchDistance::ComputeDistance(image,
+                                        ImageRegionDifferenceVsVector::GetRegionInRadiusAroundPixel(a, patchRadius),
+                                        ImageRegionDifferenceVsVector::GetRegionInRadiusAroundPixel(b, patchRadius),
+                                        distanceFunction);
+}
+
+void InitializeField(const ImageType* const image, const unsigned int patchRadius, NearestNeighborField& field)
+{
+  field.Region = GetPatchCenterRegion(image, patchRadius);
+  field.PatchRadius = patchRadius;
+  if(field.Region.GetNumberOfPixels() < 2)
+  {
+    throw std::runtime_error("The image has fewer than two patches of this radius!");
+  }
+
+  field.Matches.resize(field.Region.GetNumberOfPixels());
+  field.Distances.assign(field.Region.GetNumberOfPixels(), std::numeric_limits<float>::max());
+}
+
+/** The state of one PatchMatch run; positions are relative to the corner of the field's region. */
+class ApproximateSearch
+{
+public:
+  ApproximateSearch(const ImageType* const image, PatchDistance::PatchDistanceFunction distanceFunction,
+                    const unsigned int seed, NearestNeighborField& field) :
+    m_Image(image), m_DistanceFunction(distanceFunction), m_Field(field),
+    m_Width(field.Region.GetSize()[0]), m_Height(field.Region.GetSize()[1]), m_RandomNumbers(seed)
+  {
+  }
+
+  void InitializeRandomly()
+  {
+    std::uniform_int_distribution<long> randomX(0, m_Width - 1);
+    std::uniform_int_distribution<long> randomY(0, m_Height - 1);
+
+    for(long y = 0; y < m_Height; ++y)
+    {
+      for(long x = 0; x < m_Width; ++x)
+      {
+        long matchX;
+        long matchY;
+        do
+        {
+          matchX = randomX(m_RandomNumbers);
+          matchY = randomY(m_RandomNumbers);
+        } while(matchX == x && matchY == y);
+
+        const size_t patchId = y * m_Width + x;
+        m_Field.Matches[patchId] = GetCenter(matchX, matchY);
+        m_Field.Distances[patchId] = Distance(x, y, matchX, matchY);
+      }
+    }
+  }
+
+  /** Even iterations scan from the top left and propagate from the left and upper neighbors, odd ones scan
+   *  from the bottom right and propagate from the right and lower neighbors. */
+  void Iterate(const unsigned int iteration)
+  {
+    const long step = iteration % 2 == 0 ? 1 : -1;
+    const long beginX = step > 0 ? 0 : m_Width - 1;
+    const long beginY = step > 0 ? 0 : m_Height - 1;
+
+    for(long y = beginY; y >= 0 && y < m_Height; y += step)
+    {
+      for(long x = beginX; x >= 0 && x < m_Width; x += step)
+      {
+        // Propagation
+        if(x - step >= 0 && x - step < m_Width)
+        {
+          const itk::Index<2>& neighborMatch = m_Field.Matches[y * m_Width + x - step];
+          TryCandidate(x, y, GetX(neighborMatch) + step, GetY(neighborMatch));
+        }
+        if(y - step >= 0 && y - step < m_Height)
+        {
+          const itk::Index<2>& neighborMatch = m_Field.Matches[(y - step) * m_Width + x];
+          TryCandidate(x, y, GetX(neighborMatch), GetY(neighborMatch) + step);
+        }
+
+        // Random search
+        for(long radius = std::max(m_Width, m_Height); radius >= 1; radius /= 2)
+        {
+          const itk::Index<2>& match = m_Field.Matches[y * m_Width + x];
+          std::uniform_int_distribution<long> randomOffset(-radius, radius);
+          const long candidateX = std::min(std::max(GetX(match) + randomOffset(m_RandomNumbers), 0L), m_Width - 1);
+          const long candidateY = std::min(std::max(GetY(match) + randomOffset(m_RandomNumbers), 0L), m_Height - 1);
+          TryCandidate(x, y, candidateX, candidateY);
+        }
+      }
+    }
+  }
+
+private:
+  // Not copyable: refers to the field
+  ApproximateSearch(const ApproximateSearch&);
+  void operator=(const ApproximateSearch&);
+
+  itk::Index<2> GetCenter(const long x, const long y) const
+  {
+    itk::Index<2> center = m_Field.Region.GetIndex();
+    center[0] += x;
+    center[1] += y;
+    return center;
+  }
+
+  long GetX(const itk::Index<2>& center) const
+  {
+    return center[0] - m_Field.Region.GetIndex()[0];
+  }
+
+  long GetY(const itk::Index<2>& center) const
+  {
+    return center[1] - m_Field.Region.GetIndex()[1];
+  }
+
+  float Distance(const long x, const long y, const long matchX, const long matchY) const
+  {
+    return ComputeDistance(m_Image, m_Field.PatchRadius, m_DistanceFunction, GetCenter(x, y), GetCenter(matchX, matchY));
+  }
+
+  /** Replaces the match of (x, y) with the candidate if it is inside, not the patch itself, and closer. */
+  void TryCandidate(const long x, const long y, const long candidateX, const long candidateY)
+  {
+    if(candidateX < 0 || candidateX >= m_Width || candidateY < 0 || candidateY >= m_Height ||
+       (candidateX == x && candidateY == y))
+    {
+      return;
+    }
+
+    const size_t patchId = y * m_Width + x;
+    const float distance = Distance(x, y, candidateX, candidateY);
+    if(distance < m_Field.Distances[patchId])
+    {
+      m_Field.Matches[patchId] = GetCenter(candidateX, candidateY);
+      m_Field.Distances[patchId] = distance;
+    }
+  }
+
+  const ImageType* m_Image;
+  PatchDistance::PatchDistanceFunction m_DistanceFunction;
+  NearestNeighborField& m_Field;
+
+  const long m_Width;
+  const long m_Height;
+
+  std::mt19937 m_RandomNumbers;
+};
+
+} // end anonymous namespace
+
+itk::ImageRegion<2> GetPatchCenterRegion(const ImageType* const image, const unsigned int patchRadius)
+{
+  const itk::ImageRegion<2>& bufferedRegion = image->GetBufferedRegion();
+
+  itk::Index<2> corner;
+  itk::Size<2> size;
+  for(unsigned int dimension = 0; dimension < 2; ++dimension)
+  {
+    corner[dimension] = bufferedRegion.GetIndex()[dimension] + patchRadius;
+    size[dimension] = bufferedRegion.GetSize()[dimension] > 2 * patchRadius ?
+                      bufferedRegion.GetSize()[dimension] - 2 * patchRadius : 0;
+  }
+  return itk::ImageRegion<2>(corner, size);
+}
+
+void ComputeExactNearestNeighborField(const ImageType* const image, const unsigned int patchRadius,
+                                      PatchDistance::PatchDistanceFunction distanceFunction,
+                                      NearestNeighborField& field)
+{
+  InitializeField(image, patchRadius, field);
+
+  const itk::Index<2> corner = field.Region.GetIndex();
+  const itk::SizeValueType width = field.Region.GetSize()[0];
+
+  // ComputeDistancesToAllPatches() orders the candidates by corner, which is the order of their centers in Region
+  std::vector<float> distances;
+  for(size_t patchId = 0; patchId < field.Matches.size(); ++patchId)
+  {
+    itk::Index<2> center = {{static_cast<itk::IndexValueType>(corner[0] + patchId % width),
+                             static_cast<itk::IndexValueType>(corner[1] + patchId / width)}};
+    PatchDistance::ComputeDistancesToAllPatches(
+      image, ImageRegionDifferenceVsVector::GetRegionInRadiusAroundPixel(center, patchRadius), distanceFunction,
+      distances);
+
+    size_t bestId = patchId == 0 ? 1 : 0;
+    for(size_t candidateId = 0; candidateId < distances.size(); ++candidateId)
+    {
+      if(candidateId != patchId && distances[candidateId] < distances[bestId])
+      {
+        bestId = candidateId;
+      }
+    }
+
+    itk::Index<2> match = {{static_cast<itk::IndexValueType>(corner[0] + bestId % width),
+                            static_cast<itk::IndexValueType>(corner[1] + bestId / width)}};
+    field.Matches[patchId] = match;
+    field.Distances[patchId] = distances[bestId];
+  }
+}
+
+void ComputeApproximateNearestNeighborField(const ImageType* const image, const unsigned int patchRadius,
+                                            PatchDistance::PatchDistanceFunction distanceFunction,
+                                            const unsigned int numberOfIterations, const unsigned int seed,
+                                            NearestNeighborField& field)
+{
+  InitializeField(image, patchRadius, field);
+
+  ApproximateSearch search(image, distanceFunction, seed, field);
+  search.InitializeRandomly();
+  for(unsigned int iteration = 0; iteration < numberOfIterations; ++iteration)
+  {
+    search.Iterate(iteration);
+  }
+}
+
+MatchQuality CompareToExact(const NearestNeighborField& approximate, const NearestNeighborField& exact)
+{
+  if(approximate.Region != exact.Region || approximate.PatchRadius != exact.PatchRadius)
+  {
+    throw std::runtime_error("The fields are not for the same image and patch radius!");
+  }
+
+  size_t numberOfExactMatches = 0;
+  double approximateDistanceSum = 0;
+  double exactDistanceSum = 0;
+  for(size_t patchId = 0; patchId < exact.Distances.size(); ++patchId)
+  {
+    if(approximate.Distances[patchId] <= exact.Distances[patchId])
+    {
+      ++numberOfExactMatches;
+    }
+    approximateDistanceSum += approximate.Distances[patchId];
+    exactDistanceSum += exact.Distances[patchId];
+  }
+
+  MatchQuality quality;
+  quality.ExactMatchFraction = static_cast<double>(numberOfExactMatches) / exact.Distances.size();
+  quality.DistanceRatio = exactDistanceSum > 0 ? approximateDistanceSum / exactDistanceSum : 1;
+  return quality;
+}
+
+} // end namespace PatchMatch
@@ -0,0 +1,74 @@
+/**
+ * Demo: For every patch of an image, find the most similar other patch, either exactly by comparing it to
+ *       every other patch, or approximately with PatchMatch (Barnes et al. 2009).
+ *
+ *       The result is a nearest neighbor field: for every patch center at which a patch of the radius fits
+ *       in the image, the center of its match and their distance. Patches are made with
+ *       ImageRegionDifferenceVsVector::GetRegionInRadiusAroundPixel() and compared with
+ *       PatchDistance::ComputeDistance(), which computes the same SAD as ImageRegionDifferenceVsVector::Difference().
+ *       A patch is never matched to itself.
+ *
+ *       The exact field costs (number of patches)^2 patch comparisons. PatchMatch starts from a random field
+ *       and improves it by
+ *       - propagation: adjacent patches tend to have adjacent matches, so a patch tries the match of the
+ *         neighbor it was just visited after, shifted by one pixel (scan order alternates every iteration);
+ *       - random search: a patch tries random candidates around its current match, in windows halving
+ *         from the whole image down to one pixel;
+ *       which costs a few dozen comparisons per patch and iteration.
+ */
+
+#ifndef PatchMatch_h
+#define PatchMatch_h
+
+#include "PatchDistance.h"
+
+// STL
+#include <vector>
+
+namespace PatchMatch
+{
+
+typedef itk::Image<float, 2> ImageType;
+
+struct NearestNeighborField
+{
+  /** The centers of the patches of the radius that are entirely inside the buffered region. */
+  itk::ImageRegion<2> Region;
+  unsigned int PatchRadius;
+
+  /** Row-major over Region: the center of the match of each patch, and the distance to it. */
+  std::vector<itk::Index<2> > Matches;
+  std::vector<float> Distances;
+};
+
+/** How close an approximate field came to the exact one. */
+struct MatchQuality
+{
+  /** The fraction of patches whose match is as close as their nearest neighbor. */
+  double ExactMatchFraction;
+
+  /** The sum of the approximate match distances over the sum of the nearest neighbor distances (>= 1). */
+  double DistanceRatio;
+};
+
+/** The region of the centers of the patches of 'patchRadius' that are entirely inside the buffered region;
+ *  empty if the image is smaller than a patch. */
+itk::ImageRegion<2> GetPatchCenterRegion(const ImageType* const image, const unsigned int patchRadius);
+
+void ComputeExactNearestNeighborField(const ImageType* const image, const unsigned int patchRadius,
+                                      PatchDistance::PatchDistanceFunction distanceFunction,
+                                      NearestNeighborField& field);
+
+/** Runs 'numberOfIterations' of propagation and random search from a random field drawn with 'seed',
+ *  so the result is reproducible. */
+void ComputeApproximateNearestNeighborField(const ImageType* const image, const unsigned int patchRadius,
+                                            PatchDistance::PatchDistanceFunction distanceFunction,
+                                            const unsigned int numberOfIterations, const unsigned int seed,
+                                            NearestNeighborField& field);
+
+/** Both fields must be for the same image and radius. */
+MatchQuality CompareToExact(const NearestNeighborField& approximate, const NearestNeighborField& exact);
+
+} // end namespace PatchMatch
+
+#endif
@@ -0,0 +1,104 @@
+#include "PatchMatch.h"
+
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+// STL
+#include <cmath>
+
+namespace
+{
+
+const unsigned int seed = 1;
+
+/** A 64x64 image of smooth waves with a little noise, so that patches have similar but not identical
+ *  matches elsewhere in the image. The exact field for radius 3 is 3364^2 patch comparisons. */
+PatchMatch::ImageType::Pointer CreateTexturedImage()
+{
+  PatchMatch::ImageType::Pointer image = PatchMatch::ImageType::New();
+
+  itk::Index<2> corner = {{0,0}};
+  itk::Size<2> size = {{64, 64}};
+  image->SetRegions(itk::ImageRegion<2>(corner, size));
+  image->Allocate();
+
+  float* const buffer = image->GetBufferPointer();
+  unsigned int noise = seed;
+  for(itk::SizeValueType y = 0; y < size[1]; ++y)
+  {
+    for(itk::SizeValueType x = 0; x < size[0]; ++x)
+    {
+      noise = noise * 1103515245u + 12345u;
+      buffer[y * size[0] + x] = static_cast<float>(128 + 60 * std::sin(0.3 * x) + 50 * std::cos(0.2 * y + 0.05 * x) +
+                                                   (noise >> 16) % 16);
+    }
+  }
+  return image;
+}
+
+double SumDistances(const PatchMatch::NearestNeighborField& field)
+{
+  double sum = 0;
+  for(size_t i = 0; i < field.Distances.size(); ++i)
+  {
+    sum += field.Distances[i];
+  }
+  return sum;
+}
+
+template <unsigned int TPatchRadius>
+void ExhaustiveCase(BenchmarkState& state)
+{
+  PatchMatch::ImageType::Pointer image = CreateTexturedImage();
+  PatchDistance::PatchDistanceFunction distanceFunction =
+    PatchDistance::GetPatchDistanceFunction(PatchDistance::SumOfAbsoluteDifferences);
+  state.SetItemsPerIteration(PatchMatch::GetPatchCenterRegion(image, TPatchRadius).GetNumberOfPixels()); // patches
+
+  PatchMatch::NearestNeighborField field;
+  while(state.KeepRunning())
+  {
+    PatchMatch::ComputeExactNearestNeighborField(image, TPatchRadius, distanceFunction, field);
+    DoNotOptimize(field.Distances.data());
+    ClobberMemory();
+  }
+  state.SetChecksum(SumDistances(field));
+}
+
+/** Also reports how close the field is to the exact one, computed once outside the measured loop. */
+template <unsigned int TPatchRadius, unsigned int TNumberOfIterations>
+void PatchMatchCase(BenchmarkState& state)
+{
+  PatchMatch::ImageType::Pointer image = CreateTexturedImage();
+  PatchDistance::PatchDistanceFunction distanceFunction =
+    PatchDistance::GetPatchDistanceFunction(PatchDistance::SumOfAbsoluteDifferences);
+  state.SetItemsPerIteration(PatchMatch::GetPatchCenterRegion(image, TPatchRadius).GetNumberOfPixels()); // patches
+
+  PatchMatch::NearestNeighborField field;
+  while(state.KeepRunning())
+  {
+    PatchMatch::ComputeApproximateNearestNeighborField(image, TPatchRadius, distanceFunction, TNumberOfIterations,
+                                                       seed, field);
+    DoNotOptimize(field.Distances.data());
+    ClobberMemory();
+  }
+  state.SetChecksum(SumDistances(field));
+
+  PatchMatch::NearestNeighborField exactField;
+  PatchMatch::ComputeExactNearestNeighborField(image, TPatchRadius, distanceFunction, exactField);
+  PatchMatch::MatchQuality quality = PatchMatch::CompareToExact(field, exactField);
+  state.SetCounter("exact_match_fraction", quality.ExactMatchFraction);
+  state.SetCounter("distance_ratio", quality.DistanceRatio);
+}
+
+} // end anonymous namespace
+
+void RegisterPatchMatchBenchmarks(BenchmarkRegistry& registry)
+{
+  // The nearest neighbor (SAD) of every patch of a 64x64 image
+  registry.Add("PatchMatch/Exhaustive/Radius3", ExhaustiveCase<3>);
+  registry.Add("PatchMatch/PatchMatch/Radius3/Iterations1", PatchMatchCase<3, 1>);
+  registry.Add("PatchMatch/PatchMatch/Radius3/Iterations4", PatchMatchCase<3, 4>);
+  registry.Add("PatchMatch/Exhaustive/Radius10", ExhaustiveCase<10>);
+  registry.Add("PatchMatch/PatchMatch/Radius10/Iterations1", PatchMatchCase<10, 1>);
+  registry.Add("PatchMatch/PatchMatch/Radius10/Iterations4", PatchMatchCase<10, 4>);
+}
@@ -0,0 +1,182 @@
+/**
+ * A fixed, irregular set of offsets (a stencil) applied at many centers of one image.
+ *
+ * GetPixel(center + offset) recomputes a buffer offset from an index for every pixel of every query, and a
+ * ConstShapedNeighborhoodIterator has to be moved with SetRegion() and walks its active offset list. SetImage()
+ * converts the offsets into linear buffer offsets once, with the image's offset table, along with the
+ * interior region: the centers at which every offset lands inside the buffered region. Reduce() at an
+ * interior center is then a loop of loads at 'center pixel + linear offset'.
+ *
+ * At a center near the border, Reduce() falls back to computing the index of every pixel and clamping it
+ * to the buffered region: the nearest pixel is used, like the zero flux Neumann boundary condition of the
+ * ITK neighborhood iterators.
+ *
+ * The linear offsets are only valid for the buffered region the image had in SetImage(); call SetImage()
+ * again after changing it.
+ */
+
+#ifndef CompiledStencil_h
+#define CompiledStencil_h
+
+// ITK
+#include "itkImage.h"
+
+// STL
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace ShapedNeighborhoodIterator
+{
+
+template <typename TImage>
+class CompiledStencil
+{
+public:
+  typedef typename TImage::PixelType PixelType;
+  typedef typename TImage::IndexType IndexType;
+  typedef typename TImage::OffsetType OffsetType;
+  typedef typename TImage::SizeType SizeType;
+  typedef typename TImage::RegionType RegionType;
+
+  static const unsigned int ImageDimension = TImage::ImageDimension;
+
+  CompiledStencil() :
+    m_Image(NULL)
+  {
+  }
+
+  explicit CompiledStencil(const std::vector<OffsetType>& offsets) :
+    m_Image(NULL)
+  {
+    SetOffsets(offsets);
+  }
+
+  void SetOffsets(const std::vector<OffsetType>& offsets)
+  {
+    m_Offsets = offsets;
+    if(m_Image)
+    {
+      SetImage(m_Image);
+    }
+  }
+
+  const std::vector<OffsetType>& GetOffsets() const
+  {
+    return m_Offsets;
+  }
+
+  /** Computes the linear offsets and the interior region for the buffered region of 'image'. */
+  void SetImage(const TImage* const image)
+  {
+    if(!image)
+    {
+      throw std::runtime_error("CompiledStencil needs an image!");
+    }
+    m_Image = image;
+
+    const RegionType bufferedRegion = image->GetBufferedRegion();
+    const itk::OffsetValueType* const offsetTable = image->GetOffsetTable();
+
+    OffsetType minimumOffset;
+    OffsetType maximumOffset;
+    minimumOffset.Fill(0);
+    maximumOffset.Fill(0);
+
+    m_LinearOffsets.resize(m_Offsets.size());
+    for(size_t i = 0; i < m_Offsets.size(); ++i)
+    {
+      itk::OffsetValueType linearOffset = 0;
+      for(unsigned int dimension = 0; dimension < ImageDimension; ++dimension)
+      {
+        linearOffset += m_Offsets[i][dimension] * offsetTable[dimension];
+        minimumOffset[dimension] = std::min(minimumOffset[dimension], m_Offsets[i][dimension]);
+        maximumOffset[dimension] = std::max(maximumOffset[dimension], m_Offsets[i][dimension]);
+      }
+      m_LinearOffsets[i] = linearOffset;
+    }
+
+    // Shrink the buffered region by the extent of the offsets on each side; empty if the stencil doesn't fit
+    IndexType interiorCorner;
+    SizeType interiorSize;
+    for(unsigned int dimension = 0; dimension < ImageDimension; ++dimension)
+    {
+      const itk::OffsetValueType extent = maximumOffset[dimension] - minimumOffset[dimension];
+      const itk::OffsetValueType bufferedSize = static_cast<itk::OffsetValueType>(bufferedRegion.GetSize()[dimension]);
+      interiorCorner[dimension] = bufferedRegion.GetIndex()[dimension] - minimumOffset[dimension];
+      interiorSize[dimension] = static_cast<itk::SizeValueType>(std::max<itk::OffsetValueType>(bufferedSize - extent, 0));
+    }
+    m_InteriorRegion = RegionType(interiorCorner, interiorSize);
+  }
+
+  size_t GetNumberOfOffsets() const
+  {
+    return m_Offsets.size();
+  }
+
+  /** The centers at which Reduce() takes the fast path. */
+  const RegionType& GetInteriorRegion() const
+  {
+    return m_InteriorRegion;
+  }
+
+  /** value = function(value, pixel) for the pixel at each offset from 'center', in the order of the offsets.
+   *  'center' must be inside the buffered region. */
+  template <typename TValue, typename TFunction>
+  TValue Reduce(const IndexType& center, TValue value, TFunction function) const
+  {
+    if(!m_Image)
+    {
+      throw std::runtime_error("CompiledStencil has no image!");
+    }
+
+    if(m_InteriorRegion.IsInside(center))
+    {
+      const PixelType* const centerPixel = m_Image->GetBufferPointer() + m_Image->ComputeOffset(center);
+      const itk::OffsetValueType* const linearOffsets = m_LinearOffsets.empty() ? NULL : &m_LinearOffsets[0];
+      for(size_t i = 0; i < m_LinearOffsets.size(); ++i)
+      {
+        value = function(value, centerPixel[linearOffsets[i]]);
+      }
+      return value;
+    }
+
+    const RegionType bufferedRegion = m_Image->GetBufferedRegion();
+    if(!bufferedRegion.IsInside(center))
+    {
+      throw std::runtime_error("Cannot apply a stencil at a center outside of the buffered region!");
+    }
+
+    const IndexType& firstIndex = bufferedRegion.GetIndex();
+    IndexType lastIndex;
+    for(unsigned int dimension = 0; dimension < ImageDimension; ++dimension)
+    {
+      lastIndex[dimension] = firstIndex[dimension] + static_cast<itk::IndexValueType>(bufferedRegion.GetSize()[dimension]) - 1;
+    }
+
+    for(size_t i = 0; i < m_Offsets.size(); ++i)
+    {
+      IndexType index = center + m_Offsets[i];
+      for(unsigned int dimension = 0; dimension < ImageDimension; ++dimension)
+      {
+        index[dimension] = std::min(std::max(index[dimension], firstIndex[dimension]), lastIndex[dimension]);
+      }
+      value = function(value, m_Image->GetPixel(index));
+    }
+    return value;
+  }
+
+private:
+  const TImage* m_Image;
+
+  std::vector<OffsetType> m_Offsets;
+
+  /** m_Offsets as buffer offsets in the image's buffered region */
+  std::vector<itk::OffsetValueType> m_LinearOffsets;
+
+  RegionType m_InteriorRegion;
+};
+
+} // end namespace ShapedNeighborhoodIterator
+
+#endif
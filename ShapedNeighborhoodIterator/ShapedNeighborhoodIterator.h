@@ -0,0 +1,187 @@
+/**
+ * Demo: Compare the process of visiting a set of pixels in a region
+ *       using GetPixel() on a container of indices, versus
+ *       versus using a ShapedNeighborhoodIterator.
+ *
+ *       The iterator is compared both when it is constructed once and moved with SetRegion()
+ *       for each query, and when it is constructed (and its offsets activated) for every query.
+ *
+ *       When the set of pixels is a whole region, SumPixelsRowSpans() visits it a row at a time instead
+ *       (see ImageRowSpans.h).
+ *
+ *       SumPixelsCompiled() applies a CompiledStencil (see CompiledStencil.h), which turns the offsets into
+ *       buffer offsets once instead of at every query.
+ *
+ * Conclusion:
+ *
+ */
+
+#ifndef ShapedNeighborhoodIterator_h
+#define ShapedNeighborhoodIterator_h
+
+#include "BenchmarkImageTypes.h"
+#include "CompiledStencil.h"
+#include "ImageRowSpans.h"
+
+// ITK
+#include "itkImage.h"
+#include "itkConstShapedNeighborhoodIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+// STL
+#include <vector>
+
+namespace ShapedNeighborhoodIterator
+{
+
+///////////////////////////////////////////// Method 1 //////////////////////
+template<typename TImage>
+typename BenchmarkPixelTraits<typename TImage::PixelType>::AccumulateType
+SumPixelsManual(const TImage* const image, const typename TImage::IndexType& queryIndex,
+                const std::vector<typename TImage::OffsetType>& offsets)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  // Sum the pixels at 'offsets' relative to 'index'
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+
+  for( size_t ii = 0; ii < offsets.size(); ++ii )
+    {
+    PixelTraits::Accumulate(pixelSum, image->GetPixel(queryIndex + offsets[ii]));
+    }
+
+  return pixelSum;
+}
+
+///////////////////////////////////////////// Method 2 //////////////////////
+template<typename TShapedIterator>
+typename BenchmarkPixelTraits<typename TShapedIterator::PixelType>::AccumulateType
+SumPixelsIterator(const typename TShapedIterator::IndexType& queryIndex, TShapedIterator& shapedNeighborhoodIterator)
+{
+  typedef BenchmarkPixelTraits<typename TShapedIterator::PixelType> PixelTraits;
+
+  // Construct a 1x1 region (a single pixel)
+  typename TShapedIterator::SizeType regionSize;
+  regionSize.Fill(1);
+  typename TShapedIterator::RegionType region(queryIndex, regionSize);
+
+  shapedNeighborhoodIterator.SetRegion(region);
+
+  // Iterate over every activiated offset in the ShapedNeighborhood applied to the 'region' (single pixel) constructed above
+
+  typename TShapedIterator::ConstIterator pixelIterator = shapedNeighborhoodIterator.Begin();
+
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+
+  while (!pixelIterator.IsAtEnd())
+  {
+    PixelTraits::Accumulate(pixelSum, pixelIterator.Get());
+    ++pixelIterator;
+  }
+
+  return pixelSum;
+}
+
+///////////////////////////////////////////// Method 3 //////////////////////
+template<typename TImage>
+typename BenchmarkPixelTraits<typename TImage::PixelType>::AccumulateType
+SumPixelsIteratorPerCall(const TImage* const image, const typename TImage::IndexType& queryIndex,
+                         const std::vector<typename TImage::OffsetType>& offsets)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  // Sum the pixels at 'offsets' relative to 'index'
+
+  // Construct a 1x1 region (a single pixel)
+  typename TImage::SizeType regionSize;
+  regionSize.Fill(1);
+  typename TImage::RegionType region(queryIndex, regionSize);
+
+  // Construct a region that will surround the 1x1 region (pixel) created above
+  unsigned int patchRadius = image->GetLargestPossibleRegion().GetSize()[0]/2;
+  typename TImage::SizeType radius;
+  radius.Fill(patchRadius);
+
+  typedef itk::ConstShapedNeighborhoodIterator<TImage> ShapedIteratorType;
+  ShapedIteratorType shapedNeighborhoodIterator(radius, image, region);
+
+  // Activate all of the offsets
+  for(size_t i = 0; i < offsets.size(); ++i)
+  {
+    shapedNeighborhoodIterator.ActivateOffset(offsets[i]);
+  }
+
+  // Iterate over every activiated offset in the ShapedNeighborhood applied to the 'region' (single pixel) constructed above
+  typename ShapedIteratorType::ConstIterator pixelIterator = shapedNeighborhoodIterator.Begin();
+
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+
+  while (! pixelIterator.IsAtEnd())
+  {
+    PixelTraits::Accumulate(pixelSum, pixelIterator.Get());
+    ++pixelIterator;
+  }
+
+  return pixelSum;
+}
+
+///////////////////////////////////////////// Method 4 //////////////////////
+template<typename TImage>
+typename BenchmarkPixelTraits<typename TImage::PixelType>::AccumulateType
+SumPixelsRowSpans(const TImage* const image, const typename TImage::RegionType& region)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+
+  ForEachRowSpan(image, region, [&pixelSum](const typename TImage::PixelType* row, const size_t length,
+                                            const typename TImage::IndexType&)
+  {
+    for(size_t i = 0; i < length; ++i)
+    {
+      PixelTraits::Accumulate(pixelSum, row[i]);
+    }
+  });
+
+  return pixelSum;
+}
+
+///////////////////////////////////////////// Method 5 //////////////////////
+template<typename TImage>
+typename BenchmarkPixelTraits<typename TImage::PixelType>::AccumulateType
+SumPixelsCompiled(const typename TImage::IndexType& queryIndex, const CompiledStencil<TImage>& stencil)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+  typedef typename PixelTraits::AccumulateType AccumulateType;
+
+  return stencil.Reduce(queryIndex, PixelTraits::GetZero(),
+                        [](AccumulateType pixelSum, const typename TImage::PixelType& pixel)
+  {
+    PixelTraits::Accumulate(pixelSum, pixel);
+    return pixelSum;
+  });
+}
+
+/** Create a list of all of the offsets from 'queryIndex' to every pixel in 'region' */
+template<typename TImage>
+std::vector<typename TImage::OffsetType> GetOffsetsToRegion(const TImage* const image,
+                                                            const typename TImage::RegionType& region,
+                                                            const typename TImage::IndexType& queryIndex)
+{
+  std::vector<typename TImage::OffsetType> offsets;
+
+  itk::ImageRegionConstIteratorWithIndex<TImage> imageIterator(image, region);
+
+  while(!imageIterator.IsAtEnd())
+  {
+    offsets.push_back(imageIterator.GetIndex() - queryIndex);
+
+    ++imageIterator;
+  }
+
+  return offsets;
+}
+
+} // end namespace ShapedNeighborhoodIterator
+
+#endif
@@ -0,0 +1,194 @@
+#include "ShapedNeighborhoodIterator.h"
+
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+namespace
+{
+
+template <typename TImage>
+void CreateImage(TImage* const image)
+{
+  typename TImage::IndexType imageCorner;
+  imageCorner.Fill(0);
+  // All dimensions of the size must be odd for the logic in this code to work (11^3 is about as many pixels as 31^2)
+  typename TImage::SizeType imageSize;
+  imageSize.Fill(TImage::ImageDimension == 2 ? 31 : 11);
+  typename TImage::RegionType imageRegion(imageCorner, imageSize);
+  image->SetRegions(imageRegion);
+  image->Allocate();
+  image->FillBuffer(BenchmarkPixelTraits<typename TImage::PixelType>::MakePixel(2));
+}
+
+// This is the pixel we will repeatedly query
+template <typename TImage>
+typename TImage::IndexType GetQueryIndex(const TImage* const image)
+{
+  typename TImage::SizeType imageSize = image->GetLargestPossibleRegion().GetSize();
+  typename TImage::IndexType queryIndex;
+  queryIndex.Fill(static_cast<itk::IndexValueType>(imageSize[0]/2));
+  return queryIndex;
+}
+
+template <typename TImage>
+void SumPixelsManualCase(BenchmarkState& state)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer());
+
+  typename TImage::IndexType queryIndex = GetQueryIndex(image.GetPointer());
+  std::vector<typename TImage::OffsetType> offsets =
+    ShapedNeighborhoodIterator::GetOffsetsToRegion(image.GetPointer(), image->GetLargestPossibleRegion(), queryIndex);
+  state.SetItemsPerIteration(offsets.size());
+
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+  while(state.KeepRunning())
+  {
+    pixelSum = ShapedNeighborhoodIterator::SumPixelsManual(image.GetPointer(), queryIndex, offsets);
+    DoNotOptimize(pixelSum);
+  }
+  state.SetChecksum(PixelTraits::GetSum(pixelSum));
+}
+
+template <typename TImage>
+void SumPixelsIteratorCase(BenchmarkState& state)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer());
+
+  typename TImage::IndexType queryIndex = GetQueryIndex(image.GetPointer());
+  std::vector<typename TImage::OffsetType> offsets =
+    ShapedNeighborhoodIterator::GetOffsetsToRegion(image.GetPointer(), image->GetLargestPossibleRegion(), queryIndex);
+  state.SetItemsPerIteration(offsets.size());
+
+  // Construct a 1x1 region (a single pixel)
+  typename TImage::SizeType regionSize;
+  regionSize.Fill(1);
+  typename TImage::RegionType region(queryIndex, regionSize);
+
+  // Construct a region that will surround the 1x1 region (pixel) created above
+  unsigned int patchRadius = image->GetLargestPossibleRegion().GetSize()[0]/2;
+  typename TImage::SizeType radius;
+  radius.Fill(patchRadius);
+
+  typedef itk::ConstShapedNeighborhoodIterator<TImage> ShapedIteratorType;
+  ShapedIteratorType shapedNeighborhoodIterator(radius, image, region);
+
+  // Activate all of the offsets
+  for(size_t i = 0; i < offsets.size(); ++i)
+  {
+    shapedNeighborhoodIterator.ActivateOffset(offsets[i]);
+  }
+
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+  while(state.KeepRunning())
+  {
+    pixelSum = ShapedNeighborhoodIterator::SumPixelsIterator(queryIndex, shapedNeighborhoodIterator);
+    DoNotOptimize(pixelSum);
+  }
+  state.SetChecksum(PixelTraits::GetSum(pixelSum));
+}
+
+template <typename TImage>
+void SumPixelsIteratorPerCallCase(BenchmarkState& state)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer());
+
+  typename TImage::IndexType queryIndex = GetQueryIndex(image.GetPointer());
+  std::vector<typename TImage::OffsetType> offsets =
+    ShapedNeighborhoodIterator::GetOffsetsToRegion(image.GetPointer(), image->GetLargestPossibleRegion(), queryIndex);
+  state.SetItemsPerIteration(offsets.size());
+
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+  while(state.KeepRunning())
+  {
+    pixelSum = ShapedNeighborhoodIterator::SumPixelsIteratorPerCall(image.GetPointer(), queryIndex, offsets);
+    DoNotOptimize(pixelSum);
+  }
+  state.SetChecksum(PixelTraits::GetSum(pixelSum));
+}
+
+/** With TBorder the query is at the corner of the image, where the stencil clamps the indices of the pixels. */
+template <typename TImage, bool TBorder>
+void SumPixelsCompiledCase(BenchmarkState& state)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer());
+
+  typename TImage::IndexType queryIndex = GetQueryIndex(image.GetPointer());
+  std::vector<typename TImage::OffsetType> offsets =
+    ShapedNeighborhoodIterator::GetOffsetsToRegion(image.GetPointer(), image->GetLargestPossibleRegion(), queryIndex);
+  state.SetItemsPerIteration(offsets.size());
+
+  ShapedNeighborhoodIterator::CompiledStencil<TImage> stencil(offsets);
+  stencil.SetImage(image.GetPointer());
+  if(TBorder)
+  {
+    queryIndex = image->GetLargestPossibleRegion().GetIndex();
+  }
+
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+  while(state.KeepRunning())
+  {
+    pixelSum = ShapedNeighborhoodIterator::SumPixelsCompiled(queryIndex, stencil);
+    DoNotOptimize(pixelSum);
+  }
+  state.SetChecksum(PixelTraits::GetSum(pixelSum));
+}
+
+/** The offsets of the other cases cover the whole image, so the same pixels are the whole region. */
+template <typename TImage>
+void SumPixelsRowSpansCase(BenchmarkState& state)
+{
+  typedef BenchmarkPixelTraits<typename TImage::PixelType> PixelTraits;
+
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer());
+
+  const typename TImage::RegionType region = image->GetLargestPossibleRegion();
+  state.SetItemsPerIteration(region.GetNumberOfPixels());
+
+  typename PixelTraits::AccumulateType pixelSum = PixelTraits::GetZero();
+  while(state.KeepRunning())
+  {
+    pixelSum = ShapedNeighborhoodIterator::SumPixelsRowSpans(image.GetPointer(), region);
+    DoNotOptimize(pixelSum);
+  }
+  state.SetChecksum(PixelTraits::GetSum(pixelSum));
+}
+
+struct Registrar
+{
+  BenchmarkRegistry& Registry;
+
+  template <typename TImage>
+  void Register() const
+  {
+    const std::string imageTypeName = GetImageTypeName<TImage>();
+    Registry.Add("ShapedNeighborhoodIterator/SumPixelsManual/" + imageTypeName, SumPixelsManualCase<TImage>);
+    Registry.Add("ShapedNeighborhoodIterator/SumPixelsIterator/" + imageTypeName, SumPixelsIteratorCase<TImage>);
+    Registry.Add("ShapedNeighborhoodIterator/SumPixelsIteratorPerCall/" + imageTypeName,
+                 SumPixelsIteratorPerCallCase<TImage>);
+    Registry.Add("ShapedNeighborhoodIterator/SumPixelsRowSpans/" + imageTypeName, SumPixelsRowSpansCase<TImage>);
+    Registry.Add("ShapedNeighborhoodIterator/SumPixelsCompiled/" + imageTypeName, SumPixelsCompiledCase<TImage, false>);
+    Registry.Add("ShapedNeighborhoodIterator/SumPixelsCompiled/Border/" + imageTypeName,
+                 SumPixelsCompiledCase<TImage, true>);
+  }
+};
+
+} // end anonymous namespace
+
+void RegisterShapedNeighborhoodIteratorBenchmarks(BenchmarkRegistry& registry)
+{
+  Registrar registrar = {registry};
+  ForEachImageType(registrar);
+}
@@ -0,0 +1,38 @@
+/**
+ * Demo: Compare CovariantVector::GetSquaredNorm() to a hand written loop.
+ *
+ * Timings:
+ * -O3 and -03 -msse2 seem to be the same:
+ * Built in time: 3.049
+ * Custom time: 2.00261
+ *
+ */
+
+#ifndef SquaredNorm_h
+#define SquaredNorm_h
+
+#include "itkCovariantVector.h"
+#include "itkNumericTraits.h"
+
+namespace SquaredNorm
+{
+
+template< class T, unsigned int NVectorDimension >
+ typename itk::CovariantVector< T, NVectorDimension >::ValueType
+ CustomSquaredNorm(const typename itk::CovariantVector< T, NVectorDimension >& v)
+ {
+  typedef typename itk::CovariantVector< T, NVectorDimension >::ValueType ValueType;
+   typename itk::CovariantVector< T, NVectorDimension >::ValueType sum =
+      itk::NumericTraits< ValueType >::Zero;
+
+   for ( unsigned int i = 0; i < NVectorDimension; ++i )
+     {
+     const ValueType value = v[i];
+     sum += value * value;
+     }
+   return sum;
+ }
+
+} // end namespace SquaredNorm
+
+#endif
@@ -0,0 +1,76 @@
+#include "SquaredNorm.h"
+
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+// STL
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+
+typedef itk::CovariantVector<int, 3> VectorType;
+
+// Create random vectors
+std::vector<VectorType> CreateVectors()
+{
+  unsigned int numberOfVectors = 1e5;
+  std::vector<VectorType> vectors(numberOfVectors);
+
+  for(size_t i = 0; i < vectors.size(); ++i)
+    {
+    VectorType v;
+    v[0] = rand() % 255;
+    v[1] = rand() % 255;
+    v[2] = rand() % 255;
+    vectors[i] = v;
+    }
+  return vectors;
+}
+
+////////// Method 1: Built in /////////////
+void BuiltInCase(BenchmarkState& state)
+{
+  std::vector<VectorType> vectors = CreateVectors();
+  state.SetItemsPerIteration(vectors.size());
+
+  double builtInTotal = 0;
+  while(state.KeepRunning())
+    {
+    builtInTotal = 0;
+    for(size_t i = 0; i < vectors.size(); ++i)
+      {
+      builtInTotal += vectors[i].GetSquaredNorm();
+      }
+    DoNotOptimize(builtInTotal);
+    }
+  state.SetChecksum(builtInTotal);
+}
+
+////////// Method 2: Custom /////////////
+void CustomCase(BenchmarkState& state)
+{
+  std::vector<VectorType> vectors = CreateVectors();
+  state.SetItemsPerIteration(vectors.size());
+
+  VectorType::ComponentType customTotal = 0;
+  while(state.KeepRunning())
+    {
+    customTotal = 0;
+    for(size_t i = 0; i < vectors.size(); ++i)
+      {
+      customTotal += SquaredNorm::CustomSquaredNorm(vectors[i]);
+      }
+    DoNotOptimize(customTotal);
+    }
+  state.SetChecksum(customTotal);
+}
+
+} // end anonymous namespace
+
+void RegisterSquaredNormBenchmarks(BenchmarkRegistry& registry)
+{
+  registry.Add("SquaredNorm/BuiltIn", BuiltInCase); // 1e4 iterations took 3.049 seconds in the original demo
+  registry.Add("SquaredNorm/Custom", CustomCase); // 1e4 iterations took 2.00261 seconds in the original demo
+}
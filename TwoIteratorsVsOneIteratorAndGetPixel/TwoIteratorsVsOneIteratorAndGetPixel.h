@@ -0,0 +1,84 @@
+/**
+ * Demo: Compare every pixel of an image to itself by walking two iterators in lockstep,
+ *       versus walking one iterator and calling GetPixel() with its index,
+ *       versus walking the rows (see ImageRowSpans.h) and finding each row in the other image from its index.
+ */
+
+#ifndef TwoIteratorsVsOneIteratorAndGetPixel_h
+#define TwoIteratorsVsOneIteratorAndGetPixel_h
+
+#include "ImageRowSpans.h"
+
+// ITK
+#include "itkImage.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+namespace TwoIteratorsVsOneIteratorAndGetPixel
+{
+
+////////////// Method 1 /////////////////////////
+template <typename TImage>
+int TwoIterators(const TImage* image)
+{
+  itk::ImageRegionConstIterator<TImage> imageIterator1(image, image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<TImage> imageIterator2(image, image->GetLargestPossibleRegion());
+
+  unsigned int counter = 0;
+  while(!imageIterator1.IsAtEnd())
+  {
+    if(imageIterator1.Get() == imageIterator2.Get())
+    {
+      counter++;
+    }
+
+    ++imageIterator1;
+    ++imageIterator2;
+  }
+
+  return counter;
+}
+
+///////////////////////////////////////////// Method 2 //////////////////////
+template <typename TImage>
+int OneIteratorAndGetPixel(const TImage* image)
+{
+  itk::ImageRegionConstIteratorWithIndex<TImage> imageIterator(image, image->GetLargestPossibleRegion());
+
+  unsigned int counter = 0;
+  while(!imageIterator.IsAtEnd())
+  {
+    if(imageIterator.Get() == image->GetPixel(imageIterator.GetIndex()))
+    {
+      counter++;
+    }
+
+    ++imageIterator;
+  }
+
+  return counter;
+}
+
+///////////////////////////////////////////// Method 3 //////////////////////
+/** 'otherImage' (the same image, in the benchmark) must buffer the largest possible region of 'image'. */
+template <typename TImage>
+int RowSpans(const TImage* image, const TImage* otherImage)
+{
+  unsigned int counter = 0;
+  ForEachRowSpan(image, image->GetLargestPossibleRegion(),
+                 [otherImage, &counter](const typename TImage::PixelType* row, const size_t length,
+                                        const typename TImage::IndexType& rowStart)
+  {
+    const typename TImage::PixelType* const otherRow = &otherImage->GetPixel(rowStart);
+    for(size_t i = 0; i < length; ++i)
+    {
+      counter += (row[i] == otherRow[i]);
+    }
+  });
+
+  return counter;
+}
+
+} // end namespace TwoIteratorsVsOneIteratorAndGetPixel
+
+#endif
@@ -0,0 +1,96 @@
+#include "TwoIteratorsVsOneIteratorAndGetPixel.h"
+
+#include "BenchmarkImageTypes.h"
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+namespace
+{
+
+template <typename TImage>
+void CreateImage(TImage* const image, const unsigned int imageSize)
+{
+  AllocateImage(image, imageSize);
+  image->FillBuffer(BenchmarkPixelTraits<typename TImage::PixelType>::MakePixel(0));
+}
+
+template <typename TImage>
+void TwoIteratorsCase(BenchmarkState& state)
+{
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(2 * numberOfPixels * sizeof(typename TImage::PixelType));
+
+  unsigned int counter = 0;
+  while(state.KeepRunning())
+  {
+    counter = TwoIteratorsVsOneIteratorAndGetPixel::TwoIterators(image.GetPointer());
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+template <typename TImage>
+void OneIteratorAndGetPixelCase(BenchmarkState& state)
+{
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(2 * numberOfPixels * sizeof(typename TImage::PixelType));
+
+  unsigned int counter = 0;
+  while(state.KeepRunning())
+  {
+    counter = TwoIteratorsVsOneIteratorAndGetPixel::OneIteratorAndGetPixel(image.GetPointer());
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+template <typename TImage>
+void RowSpansCase(BenchmarkState& state)
+{
+  typename TImage::Pointer image = TImage::New();
+  CreateImage(image.GetPointer(), state.GetImageSize());
+  const double numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(2 * numberOfPixels * sizeof(typename TImage::PixelType));
+
+  unsigned int counter = 0;
+  while(state.KeepRunning())
+  {
+    // Otherwise the compiler sees that both rows are the same and doesn't compare them
+    const TImage* otherImage = image.GetPointer();
+    DoNotOptimize(otherImage);
+
+    counter = TwoIteratorsVsOneIteratorAndGetPixel::RowSpans(image.GetPointer(), otherImage);
+    DoNotOptimize(counter);
+  }
+  state.SetChecksum(counter);
+}
+
+struct Registrar
+{
+  BenchmarkRegistry& Registry;
+
+  template <typename TImage>
+  void Register() const
+  {
+    const std::string imageTypeName = GetImageTypeName<TImage>();
+    Registry.Add("TwoIteratorsVsOneIteratorAndGetPixel/TwoIterators/" + imageTypeName, TwoIteratorsCase<TImage>, 10);
+    Registry.Add("TwoIteratorsVsOneIteratorAndGetPixel/OneIteratorAndGetPixel/" + imageTypeName, OneIteratorAndGetPixelCase<TImage>, 10);
+    Registry.Add("TwoIteratorsVsOneIteratorAndGetPixel/RowSpans/" + imageTypeName, RowSpansCase<TImage>, 10);
+  }
+};
+
+} // end anonymous namespace
+
+void RegisterTwoIteratorsVsOneIteratorAndGetPixelBenchmarks(BenchmarkRegistry& registry)
+{
+  // For uint8/2D, 1e6 iterations took about 7.6 (TwoIterators) and 9.5 (OneIteratorAndGetPixel) seconds in the original demo
+  Registrar registrar = {registry};
+  ForEachImageType(registrar);
+}
@@ -0,0 +1,97 @@
+/**
+ * Kernels over the components of VectorImage pixels, compiled for the common numbers of components.
+ *
+ * An Image<CovariantVector<float, N>> is fast because N is a compile time constant: the loops over the
+ * components are unrolled and vectorized. A VectorImage only knows GetNumberOfComponentsPerPixel() at
+ * runtime. A kernel written against a ComponentCount gets both: ComponentCount<N>::Get() is the constant N,
+ * and ComponentCount<0> (RuntimeComponentCount) holds a count known at runtime only.
+ *
+ * DispatchComponentCount(numberOfComponents, function) calls function(ComponentCount<N>()) if
+ * numberOfComponents is one of the counts with a compiled instantiation (3, 4, 8, 16, 32, 64, 100 and 128),
+ * and function(RuntimeComponentCount(numberOfComponents)) otherwise. 'function' must accept any
+ * ComponentCount; in C++11 that is a function object with a template operator():
+ *
+ *   struct SumKernel
+ *   {
+ *     template <typename TComponentCount>
+ *     float operator()(const TComponentCount count) const { return Sum(m_Pixels, count); }
+ *     ...
+ *   };
+ *   float sum = DispatchComponentCount(image->GetNumberOfComponentsPerPixel(), SumKernel(...));
+ *
+ * Every dispatched count instantiates the kernel once more; the list is short on purpose.
+ */
+
+#ifndef ComponentCountDispatch_h
+#define ComponentCountDispatch_h
+
+// STL
+#include <cstddef>
+
+namespace VectorImageVsImageCovariantVector
+{
+
+template <unsigned int VNumberOfComponents>
+class ComponentCount
+{
+public:
+  static const unsigned int NumberOfComponents = VNumberOfComponents;
+
+  size_t Get() const
+  {
+    return VNumberOfComponents;
+  }
+};
+
+template <>
+class ComponentCount<0>
+{
+public:
+  static const unsigned int NumberOfComponents = 0;
+
+  explicit ComponentCount(const size_t numberOfComponents) :
+    m_NumberOfComponents(numberOfComponents)
+  {
+  }
+
+  size_t Get() const
+  {
+    return m_NumberOfComponents;
+  }
+
+private:
+  size_t m_NumberOfComponents;
+};
+
+typedef ComponentCount<0> RuntimeComponentCount;
+
+template <typename TFunction>
+auto DispatchComponentCount(const size_t numberOfComponents, const TFunction& function)
+  -> decltype(function(RuntimeComponentCount(numberOfComponents)))
+{
+  switch(numberOfComponents)
+    {
+    case 3:
+      return function(ComponentCount<3>());
+    case 4:
+      return function(ComponentCount<4>());
+    case 8:
+      return function(ComponentCount<8>());
+    case 16:
+      return function(ComponentCount<16>());
+    case 32:
+      return function(ComponentCount<32>());
+    case 64:
+      return function(ComponentCount<64>());
+    case 100:
+      return function(ComponentCount<100>());
+    case 128:
+      return function(ComponentCount<128>());
+    default:
+      return function(RuntimeComponentCount(numberOfComponents));
+    }
+}
+
+} // end namespace VectorImageVsImageCovariantVector
+
+#endif
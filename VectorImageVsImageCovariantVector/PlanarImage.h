@@ -0,0 +1,307 @@
+/**
+ * A multi-component image stored as one plane per component ("structure of arrays"), and conversions to and
+ * from the pixel-interleaved VectorImage.
+ *
+ * A VectorImage keeps the components of a pixel together, so a kernel that reads one or two components of
+ * every pixel pulls whole pixels through the cache: with 100 float components, a cache line per pixel for
+ * 4 useful bytes. A PlanarImage keeps each component of all the pixels together instead: plane c holds
+ * component c of every pixel of the buffered region in row-major order, so such a kernel reads only the
+ * planes it needs, front to back. Kernels that use all the components of a pixel at once, like a distance
+ * between pixels, read every plane in step instead and are usually better off interleaved.
+ *
+ * Planes start on a cache line boundary: the distance between the starts of two planes is the number of
+ * pixels rounded up to a cache line.
+ *
+ * The conversions transpose a block of pixels at a time, so the pixels of the block stay in the cache while
+ * each of their components is copied to its plane (to planar), and the block's part of every plane stays in
+ * the cache while the pixels are written one after the other (to interleaved).
+ */
+
+#ifndef PlanarImage_h
+#define PlanarImage_h
+
+#include "VectorImageDistances.h"
+#include "VectorImageVsImageCovariantVector.h"
+
+// ITK
+#include "itkImageRegion.h"
+#include "itkVectorImage.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace VectorImageVsImageCovariantVector
+{
+
+template <typename TComponent, unsigned int VDimension>
+class PlanarImage
+{
+public:
+  typedef TComponent ComponentType;
+  typedef itk::ImageRegion<VDimension> RegionType;
+  typedef itk::Index<VDimension> IndexType;
+
+  static const unsigned int ImageDimension = VDimension;
+
+  /** Bytes */
+  static const size_t Alignment = 64;
+
+  PlanarImage() :
+    m_NumberOfComponents(0), m_PlaneStride(0), m_Data(NULL)
+    {
+    }
+
+  void SetRegions(const RegionType& region)
+    {
+    m_BufferedRegion = region;
+    }
+
+  const RegionType& GetBufferedRegion() const
+    {
+    return m_BufferedRegion;
+    }
+
+  void SetNumberOfComponentsPerPixel(const unsigned int numberOfComponents)
+    {
+    m_NumberOfComponents = numberOfComponents;
+    }
+
+  unsigned int GetNumberOfComponentsPerPixel() const
+    {
+    return m_NumberOfComponents;
+    }
+
+  /** Allocates the planes for the region and number of components; discards the contents, the new components
+   *  are all zero. */
+  void Allocate()
+    {
+    const size_t componentsPerAlignment = Alignment / sizeof(TComponent);
+    const size_t numberOfPixels = m_BufferedRegion.GetNumberOfPixels();
+    m_PlaneStride = (numberOfPixels + componentsPerAlignment - 1) / componentsPerAlignment * componentsPerAlignment;
+
+    // std::vector doesn't over-align, so allocate a spare alignment's worth and start at the first boundary
+    m_Storage.assign(m_NumberOfComponents * m_PlaneStride + componentsPerAlignment, TComponent());
+    const uintptr_t address = reinterpret_cast<uintptr_t>(&m_Storage[0]);
+    m_Data = &m_Storage[0] + ((Alignment - address % Alignment) % Alignment) / sizeof(TComponent);
+    }
+
+  /** The distance in components between the starts of consecutive planes. */
+  size_t GetPlaneStride() const
+    {
+    return m_PlaneStride;
+    }
+
+  TComponent* GetPlane(const unsigned int component)
+    {
+    return m_Data + component * m_PlaneStride;
+    }
+
+  const TComponent* GetPlane(const unsigned int component) const
+    {
+    return m_Data + component * m_PlaneStride;
+    }
+
+  /** The position of the pixel at 'index' in every plane. */
+  size_t ComputeOffset(const IndexType& index) const
+    {
+    size_t offset = 0;
+    for(unsigned int dimension = VDimension; dimension-- > 0;)
+      {
+      offset = offset * m_BufferedRegion.GetSize()[dimension] +
+               static_cast<size_t>(index[dimension] - m_BufferedRegion.GetIndex()[dimension]);
+      }
+    return offset;
+    }
+
+private:
+  // Not copyable: m_Data points into m_Storage, and a copy may need a different offset to be aligned
+  PlanarImage(const PlanarImage&);
+  void operator=(const PlanarImage&);
+
+  RegionType m_BufferedRegion;
+  unsigned int m_NumberOfComponents;
+  size_t m_PlaneStride;
+
+  std::vector<TComponent> m_Storage;
+  TComponent* m_Data;
+};
+
+typedef PlanarImage<float, 2> PlanarImageType;
+
+/** The number of pixels the conversions transpose at a time: with 100 float components, 25 kB. */
+const size_t pixelsPerConversionBlock = 64;
+
+/** 'planar' gets the buffered region, the number of components and the pixels of 'image'. */
+template <typename TComponent, unsigned int VDimension>
+void ConvertToPlanar(const itk::VectorImage<TComponent, VDimension>* const image,
+                     PlanarImage<TComponent, VDimension>& planar)
+{
+  const unsigned int numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  if(planar.GetBufferedRegion() != image->GetBufferedRegion() ||
+     planar.GetNumberOfComponentsPerPixel() != numberOfComponents)
+    {
+    planar.SetRegions(image->GetBufferedRegion());
+    planar.SetNumberOfComponentsPerPixel(numberOfComponents);
+    planar.Allocate();
+    }
+
+  const size_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  const TComponent* const buffer = image->GetBufferPointer();
+  for(size_t firstPixel = 0; firstPixel < numberOfPixels; firstPixel += pixelsPerConversionBlock)
+    {
+    const size_t endPixel = std::min(firstPixel + pixelsPerConversionBlock, numberOfPixels);
+    for(unsigned int component = 0; component < numberOfComponents; ++component)
+      {
+      TComponent* const plane = planar.GetPlane(component);
+      for(size_t pixel = firstPixel; pixel < endPixel; ++pixel)
+        {
+        plane[pixel] = buffer[pixel * numberOfComponents + component];
+        }
+      }
+    }
+}
+
+/** 'image' gets the buffered region, the number of components and the pixels of 'planar'. */
+template <typename TComponent, unsigned int VDimension>
+void ConvertToInterleaved(const PlanarImage<TComponent, VDimension>& planar,
+                          itk::VectorImage<TComponent, VDimension>* const image)
+{
+  const unsigned int numberOfComponents = planar.GetNumberOfComponentsPerPixel();
+  if(image->GetBufferedRegion() != planar.GetBufferedRegion() ||
+     image->GetNumberOfComponentsPerPixel() != numberOfComponents)
+    {
+    image->SetRegions(planar.GetBufferedRegion());
+    image->SetNumberOfComponentsPerPixel(numberOfComponents);
+    image->Allocate();
+    }
+
+  // Each pixel is written whole, front to back; the block's lines of every plane stay in the cache meanwhile
+  const size_t numberOfPixels = planar.GetBufferedRegion().GetNumberOfPixels();
+  const size_t planeStride = planar.GetPlaneStride();
+  const TComponent* const planes = planar.GetPlane(0);
+  TComponent* const buffer = image->GetBufferPointer();
+  for(size_t firstPixel = 0; firstPixel < numberOfPixels; firstPixel += pixelsPerConversionBlock)
+    {
+    const size_t endPixel = std::min(firstPixel + pixelsPerConversionBlock, numberOfPixels);
+    for(size_t pixel = firstPixel; pixel < endPixel; ++pixel)
+      {
+      TComponent* const pixelComponents = buffer + pixel * numberOfComponents;
+      for(unsigned int component = 0; component < numberOfComponents; ++component)
+        {
+        pixelComponents[component] = planes[component * planeStride + pixel];
+        }
+      }
+    }
+}
+
+/** The sum of component 'component' of every pixel. */
+inline double SumComponent(const VectorImageType* const image, const unsigned int component)
+{
+  const size_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  const size_t numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  const float* const buffer = image->GetBufferPointer() + component;
+
+  double sum = 0.0;
+  for(size_t pixel = 0; pixel < numberOfPixels; ++pixel)
+    {
+    sum += buffer[pixel * numberOfComponents];
+    }
+  return sum;
+}
+
+inline double SumComponent(const PlanarImageType& image, const unsigned int component)
+{
+  const size_t numberOfPixels = image.GetBufferedRegion().GetNumberOfPixels();
+  const float* const plane = image.GetPlane(component);
+
+  double sum = 0.0;
+  for(size_t pixel = 0; pixel < numberOfPixels; ++pixel)
+    {
+    sum += plane[pixel];
+    }
+  return sum;
+}
+
+/** The sum over every pixel of |component a - component b|. */
+inline double SumAbsoluteComponentDifference(const VectorImageType* const image, const unsigned int a,
+                                             const unsigned int b)
+{
+  const size_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  const size_t numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  const float* const buffer = image->GetBufferPointer();
+
+  double sum = 0.0;
+  for(size_t pixel = 0; pixel < numberOfPixels; ++pixel)
+    {
+    sum += std::fabs(buffer[pixel * numberOfComponents + a] - buffer[pixel * numberOfComponents + b]);
+    }
+  return sum;
+}
+
+inline double SumAbsoluteComponentDifference(const PlanarImageType& image, const unsigned int a, const unsigned int b)
+{
+  const size_t numberOfPixels = image.GetBufferedRegion().GetNumberOfPixels();
+  const float* const planeA = image.GetPlane(a);
+  const float* const planeB = image.GetPlane(b);
+
+  double sum = 0.0;
+  for(size_t pixel = 0; pixel < numberOfPixels; ++pixel)
+    {
+    sum += std::fabs(planeA[pixel] - planeB[pixel]);
+    }
+  return sum;
+}
+
+/** The number of pixels whose distances ComputeDistances() accumulates over all the planes at a time: few enough
+ *  for the partial distances to stay in the L1 cache. */
+const size_t pixelsPerDistanceBlock = 1024;
+
+/** As ComputeDistances() on a VectorImage, in buffer order: the distances of a block of pixels are accumulated a
+ *  plane at a time. */
+inline void ComputeDistances(const PlanarImageType& image, const float* const reference, const DistanceNorm norm,
+                             std::vector<float>& distances)
+{
+  const size_t numberOfPixels = image.GetBufferedRegion().GetNumberOfPixels();
+  distances.assign(numberOfPixels, 0.0f);
+
+  for(size_t firstPixel = 0; firstPixel < numberOfPixels; firstPixel += pixelsPerDistanceBlock)
+    {
+    const size_t blockSize = std::min(pixelsPerDistanceBlock, numberOfPixels - firstPixel);
+    float* const blockDistances = &distances[firstPixel];
+    for(unsigned int component = 0; component < image.GetNumberOfComponentsPerPixel(); ++component)
+      {
+      const float* const plane = image.GetPlane(component) + firstPixel;
+      const float referenceComponent = reference[component];
+      if(norm == L1Distance)
+        {
+        for(size_t pixel = 0; pixel < blockSize; ++pixel)
+          {
+          blockDistances[pixel] += std::fabs(plane[pixel] - referenceComponent);
+          }
+        }
+      else
+        {
+        for(size_t pixel = 0; pixel < blockSize; ++pixel)
+          {
+          const float difference = plane[pixel] - referenceComponent;
+          blockDistances[pixel] += difference * difference;
+          }
+        }
+      }
+
+    if(norm == L2Distance)
+      {
+      for(size_t pixel = 0; pixel < blockSize; ++pixel)
+        {
+        blockDistances[pixel] = std::sqrt(blockDistances[pixel]);
+        }
+      }
+    }
+}
+
+} // end namespace VectorImageVsImageCovariantVector
+
+#endif
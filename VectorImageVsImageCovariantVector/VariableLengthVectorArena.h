@@ -0,0 +1,94 @@
+/**
+ * One block of memory for the components of every pixel of an Image<VariableLengthVector>.
+ *
+ * Giving each pixel of an Image<VariableLengthVector> its components with SetSize() is one heap allocation
+ * per pixel (250000 for the images of this demo), and as many deallocations when the image goes away; the
+ * components end up wherever the allocator put them. VariableLengthVectorArena::Allocate() allocates the
+ * image and makes every pixel a view (a VariableLengthVector that doesn't manage its memory) of its part of a
+ * single array: pixel i gets the components [i * numberOfComponents, (i + 1) * numberOfComponents), so
+ * visiting the pixels in buffer order reads the array front to back.
+ *
+ * The pixels point into the arena, so the arena must outlive the image (destroy the image first, or allocate
+ * it again, or declare the arena before it). Assigning a pixel of the same size copies into the arena;
+ * giving a pixel another size makes it allocate memory of its own, as usual.
+ */
+
+#ifndef VariableLengthVectorArena_h
+#define VariableLengthVectorArena_h
+
+// ITK
+#include "itkImage.h"
+#include "itkVariableLengthVector.h"
+
+// STL
+#include <vector>
+
+namespace VectorImageVsImageCovariantVector
+{
+
+template <typename TValue>
+class VariableLengthVectorArena
+{
+public:
+  typedef TValue ValueType;
+  typedef itk::VariableLengthVector<TValue> VectorType;
+
+  VariableLengthVectorArena() :
+    m_NumberOfComponents(0)
+    {
+    }
+
+  /** Allocates 'image' with 'region', and every pixel as a view of 'numberOfComponents' zero components of the
+   *  arena. Pixels of an image allocated before by this arena are left pointing into freed memory. */
+  template <unsigned int VDimension>
+  void Allocate(itk::Image<VectorType, VDimension>* const image, const itk::ImageRegion<VDimension>& region,
+                const unsigned int numberOfComponents)
+    {
+    image->SetRegions(region);
+    image->Allocate();
+
+    const size_t numberOfPixels = region.GetNumberOfPixels();
+    m_NumberOfComponents = numberOfComponents;
+    m_Storage.assign(numberOfPixels * numberOfComponents, TValue());
+
+    VectorType* const pixels = image->GetBufferPointer();
+    TValue* components = m_Storage.empty() ? NULL : &m_Storage[0];
+    for(size_t pixel = 0; pixel < numberOfPixels; ++pixel, components += numberOfComponents)
+      {
+      pixels[pixel].SetData(components, numberOfComponents, false);
+      }
+    }
+
+  unsigned int GetNumberOfComponents() const
+    {
+    return m_NumberOfComponents;
+    }
+
+  /** The components of all the pixels, in buffer order. */
+  size_t GetSize() const
+    {
+    return m_Storage.size();
+    }
+
+  TValue* GetData()
+    {
+    return m_Storage.empty() ? NULL : &m_Storage[0];
+    }
+
+  const TValue* GetData() const
+    {
+    return m_Storage.empty() ? NULL : &m_Storage[0];
+    }
+
+private:
+  // Not copyable: the pixels of the image point into m_Storage
+  VariableLengthVectorArena(const VariableLengthVectorArena&);
+  void operator=(const VariableLengthVectorArena&);
+
+  unsigned int m_NumberOfComponents;
+  std::vector<TValue> m_Storage;
+};
+
+} // end namespace VectorImageVsImageCovariantVector
+
+#endif
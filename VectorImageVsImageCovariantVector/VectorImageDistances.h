@@ -0,0 +1,197 @@
+/**
+ * The L1 or L2 distance from a reference pixel to every pixel of a VectorImage, in bulk.
+ *
+ * A VectorImage stores its pixels as one flat buffer of components, pixel after pixel. ComputeDistances()
+ * streams through it and writes one distance per pixel, without making a VariableLengthVector for the
+ * pixel or for the difference. A pixel is a patch of one row for the patch distance kernels of
+ * PatchDistance (SAD for L1, SSD for L2, followed by a square root), so the components are compared with
+ * the SSE or AVX2 kernels chosen at runtime, whatever the number of components.
+ *
+ * ComputeDistancesParallel() splits the pixels into blocks computed on a ThreadPool; each pixel's
+ * distance doesn't depend on the split.
+ *
+ * ComputeDistancesDispatched() uses plain loops instead, compiled for the number of components when it is a
+ * common one (see ComponentCountDispatch.h). They sum the components into distanceLanes interleaved
+ * partial sums, which the compiler turns into vector registers; with a constant number of components the
+ * loops are unrolled too.
+ */
+
+#ifndef VectorImageDistances_h
+#define VectorImageDistances_h
+
+#include "ComponentCountDispatch.h"
+#include "PatchDistance.h"
+#include "ThreadPool.h"
+#include "VectorImageVsImageCovariantVector.h"
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace VectorImageVsImageCovariantVector
+{
+
+enum DistanceNorm
+{
+  L1Distance,
+  L2Distance
+};
+
+/** distances[i] is the distance between 'reference' and pixel i of the 'numberOfPixels' pixels of
+ *  'numberOfComponents' components that start at 'pixels'. */
+inline void ComputeDistances(const float* const pixels, const size_t numberOfPixels, const size_t numberOfComponents,
+                             const float* const reference, const DistanceNorm norm,
+                             const PatchDistance::InstructionSet instructionSet, float* const distances)
+{
+  const PatchDistance::PatchDistanceFunction distanceFunction = PatchDistance::GetPatchDistanceFunction(
+    norm == L1Distance ? PatchDistance::SumOfAbsoluteDifferences : PatchDistance::SumOfSquaredDifferences,
+    instructionSet);
+
+  for(size_t pixel = 0; pixel < numberOfPixels; ++pixel)
+    {
+    distances[pixel] = distanceFunction(reference, 0, pixels + pixel * numberOfComponents, 0, numberOfComponents, 1);
+    }
+
+  if(norm == L2Distance)
+    {
+    for(size_t pixel = 0; pixel < numberOfPixels; ++pixel)
+      {
+      distances[pixel] = std::sqrt(distances[pixel]);
+      }
+    }
+}
+
+/** The distances to 'reference' (GetNumberOfComponentsPerPixel() components) of the pixels of the buffered
+ *  region, in buffer order. */
+inline void ComputeDistances(const VectorImageType* const image, const float* const reference, const DistanceNorm norm,
+                             const PatchDistance::InstructionSet instructionSet, std::vector<float>& distances)
+{
+  distances.resize(image->GetBufferedRegion().GetNumberOfPixels());
+  if(!distances.empty())
+    {
+    ComputeDistances(image->GetBufferPointer(), distances.size(), image->GetNumberOfComponentsPerPixel(), reference,
+                     norm, instructionSet, &distances[0]);
+    }
+}
+
+inline void ComputeDistancesParallel(const VectorImageType* const image, const float* const reference,
+                                     const DistanceNorm norm, const PatchDistance::InstructionSet instructionSet,
+                                     std::vector<float>& distances, ThreadPool& pool)
+{
+  const size_t numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  distances.resize(numberOfPixels);
+  if(numberOfPixels == 0)
+    {
+    return;
+    }
+
+  // Several blocks per thread to balance the load
+  const size_t numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  const size_t numberOfBlocks = std::min<size_t>(numberOfPixels, 4 * pool.GetNumberOfThreads());
+  const float* const buffer = image->GetBufferPointer();
+  float* const blockDistances = &distances[0];
+  pool.ParallelFor(numberOfBlocks, [&](const size_t blockId)
+    {
+    const size_t firstPixel = blockId * numberOfPixels / numberOfBlocks;
+    const size_t endPixel = (blockId + 1) * numberOfPixels / numberOfBlocks;
+    ComputeDistances(buffer + firstPixel * numberOfComponents, endPixel - firstPixel, numberOfComponents, reference,
+                     norm, instructionSet, blockDistances + firstPixel);
+    });
+}
+
+/** The number of partial sums of the distance of one pixel in the compiled kernels. */
+const size_t distanceLanes = 8;
+
+template <DistanceNorm TNorm>
+inline float ComputeComponentDistance(const float a, const float b)
+{
+  const float difference = a - b;
+  return TNorm == L1Distance ? std::fabs(difference) : difference * difference;
+}
+
+/** As ComputeDistances(), with the number of components given by 'componentCount'. */
+template <DistanceNorm TNorm, typename TComponentCount>
+void ComputeDistances(const float* pixels, const size_t numberOfPixels, const TComponentCount componentCount,
+                      const float* const reference, float* const distances)
+{
+  const size_t numberOfComponents = componentCount.Get();
+  const size_t numberOfLaneComponents = numberOfComponents - numberOfComponents % distanceLanes;
+
+  for(size_t pixel = 0; pixel < numberOfPixels; ++pixel, pixels += numberOfComponents)
+    {
+    float sums[distanceLanes] = {};
+    size_t component = 0;
+    for(; component < numberOfLaneComponents; component += distanceLanes)
+      {
+      for(size_t lane = 0; lane < distanceLanes; ++lane)
+        {
+        sums[lane] += ComputeComponentDistance<TNorm>(reference[component + lane], pixels[component + lane]);
+        }
+      }
+    for(; component < numberOfComponents; ++component)
+      {
+      sums[0] += ComputeComponentDistance<TNorm>(reference[component], pixels[component]);
+      }
+
+    float distance = 0.0f;
+    for(size_t lane = 0; lane < distanceLanes; ++lane)
+      {
+      distance += sums[lane];
+      }
+    distances[pixel] = distance;
+    }
+
+  // In a loop of its own: the call to sqrt() (which may set errno) would keep the loop above from being vectorized
+  if(TNorm == L2Distance)
+    {
+    for(size_t pixel = 0; pixel < numberOfPixels; ++pixel)
+      {
+      distances[pixel] = std::sqrt(distances[pixel]);
+      }
+    }
+}
+
+template <DistanceNorm TNorm>
+struct ComputeDistancesKernel
+{
+  const float* Pixels;
+  size_t NumberOfPixels;
+  const float* Reference;
+  float* Distances;
+
+  template <typename TComponentCount>
+  void operator()(const TComponentCount componentCount) const
+  {
+    ComputeDistances<TNorm>(Pixels, NumberOfPixels, componentCount, Reference, Distances);
+  }
+};
+
+/** As ComputeDistances(image, ...), with the compiled kernel for the number of components of 'image'. */
+inline void ComputeDistancesDispatched(const VectorImageType* const image, const float* const reference,
+                                       const DistanceNorm norm, std::vector<float>& distances)
+{
+  distances.resize(image->GetBufferedRegion().GetNumberOfPixels());
+  if(distances.empty())
+    {
+    return;
+    }
+
+  const size_t numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  if(norm == L1Distance)
+    {
+    const ComputeDistancesKernel<L1Distance> kernel = {image->GetBufferPointer(), distances.size(), reference,
+                                                       &distances[0]};
+    DispatchComponentCount(numberOfComponents, kernel);
+    }
+  else
+    {
+    const ComputeDistancesKernel<L2Distance> kernel = {image->GetBufferPointer(), distances.size(), reference,
+                                                       &distances[0]};
+    DispatchComponentCount(numberOfComponents, kernel);
+    }
+}
+
+} // end namespace VectorImageVsImageCovariantVector
+
+#endif
@@ -0,0 +1,187 @@
+/**
+ * Demo: Compute the norm of the difference between the first pixel and every pixel of a
+ *       multi-component image stored as an Image<CovariantVector>, an Image<VariableLengthVector>
+ *       and a VectorImage.
+ *
+ *       CompareImageRowSpans() visits the pixels a row at a time (see ImageRowSpans.h); on a VectorImage it
+ *       reads the components straight from the buffer instead of making a VariableLengthVector per pixel.
+ *       CompareImageRowSpansDispatched() does so with the number of components as a compile time constant
+ *       when it is a common one (see ComponentCountDispatch.h), like the length of a CovariantVector.
+ *
+ *       ComputeDistances() (VectorImageDistances.h) writes the L1 or L2 distance of every pixel of a VectorImage
+ *       to a reference pixel, comparing the components with the SIMD kernels of PatchDistance.
+ *
+ *       PlanarImage (PlanarImage.h) stores one plane per component instead of interleaving the components of a
+ *       pixel, for kernels that read only one or two components of every pixel.
+ *
+ *       VariableLengthVectorArena (VariableLengthVectorArena.h) allocates an Image<VariableLengthVector> with
+ *       the components of all its pixels in one array, instead of a heap allocation per pixel.
+ *
+ * Conclusion: Image<CovariantVector> is almost 4x faster than VectorImage when performing lots of pixel differences!
+ */
+
+#ifndef VectorImageVsImageCovariantVector_h
+#define VectorImageVsImageCovariantVector_h
+
+#include "ComponentCountDispatch.h"
+#include "ImageRowSpans.h"
+
+#include "itkCovariantVector.h"
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkVariableLengthVector.h"
+#include "itkVectorImage.h"
+
+// STL
+#include <cmath>
+#include <cstdlib>
+
+namespace VectorImageVsImageCovariantVector
+{
+
+const unsigned int pixelDimension = 100;
+
+typedef itk::Image<itk::CovariantVector<float, pixelDimension>, 2> ImageFixedLengthType;
+typedef itk::Image<itk::VariableLengthVector<float>, 2> ImageVariableLengthType;
+typedef itk::VectorImage<float, 2> VectorImageType;
+
+const unsigned int imageSize = 500;
+
+/** Sum of the norms of the differences between the first pixel and every pixel. */
+template <typename TImage>
+float CompareImage(TImage* const image)
+{
+  float totalDifference = 0.0f;
+
+  itk::ImageRegionIterator<TImage> imageIterator(image, image->GetLargestPossibleRegion());
+  typename TImage::PixelType p = image->GetPixel(image->GetLargestPossibleRegion().GetIndex());
+  while(!imageIterator.IsAtEnd())
+    {
+    totalDifference += (p - imageIterator.Get()).GetNorm();
+    ++imageIterator;
+    }
+
+  return totalDifference;
+}
+
+template <typename TImage>
+float CompareImageRowSpans(const TImage* const image)
+{
+  float totalDifference = 0.0f;
+
+  const typename TImage::PixelType p = image->GetPixel(image->GetLargestPossibleRegion().GetIndex());
+  ForEachRowSpan(image, image->GetLargestPossibleRegion(),
+                 [&p, &totalDifference](const typename TImage::PixelType* row, const size_t length, const itk::Index<2>&)
+    {
+    for(size_t i = 0; i < length; ++i)
+      {
+      totalDifference += (p - row[i]).GetNorm();
+      }
+    });
+
+  return totalDifference;
+}
+
+/** The components of 'image' are read as 'componentCount' of them per pixel (see ComponentCountDispatch.h). */
+template <typename TComponentCount>
+float CompareImageRowSpans(const VectorImageType* const image, const TComponentCount componentCount)
+{
+  float totalDifference = 0.0f;
+
+  const size_t numberOfComponents = componentCount.Get();
+  const float* const p =
+    image->GetBufferPointer() + image->ComputeOffset(image->GetLargestPossibleRegion().GetIndex()) * numberOfComponents;
+  ForEachRowSpan(image, image->GetLargestPossibleRegion(),
+                 [p, componentCount, &totalDifference](const float* row, const size_t length, const itk::Index<2>&)
+    {
+    const size_t numberOfComponents = componentCount.Get();
+    for(const float* const rowEnd = row + length * numberOfComponents; row < rowEnd; row += numberOfComponents)
+      {
+      double squaredNorm = 0.0;
+      for(size_t component = 0; component < numberOfComponents; ++component)
+        {
+        const float difference = p[component] - row[component];
+        squaredNorm += difference * difference;
+        }
+      totalDifference += std::sqrt(squaredNorm);
+      }
+    });
+
+  return totalDifference;
+}
+
+inline float CompareImageRowSpans(const VectorImageType* const image)
+{
+  return CompareImageRowSpans(image, RuntimeComponentCount(image->GetNumberOfComponentsPerPixel()));
+}
+
+struct CompareImageRowSpansKernel
+{
+  const VectorImageType* Image;
+
+  template <typename TComponentCount>
+  float operator()(const TComponentCount componentCount) const
+  {
+    return CompareImageRowSpans(Image, componentCount);
+  }
+};
+
+/** CompareImageRowSpans() compiled for the number of components of 'image' if it is a common one. */
+inline float CompareImageRowSpansDispatched(const VectorImageType* const image)
+{
+  const CompareImageRowSpansKernel kernel = {image};
+  return DispatchComponentCount(image->GetNumberOfComponentsPerPixel(), kernel);
+}
+
+inline void CreateImages(ImageFixedLengthType* const fixedLengthImage, ImageVariableLengthType* const variableLengthImage, VectorImageType* const vectorImage)
+{
+  itk::Index<2> corner = {{0,0}};
+  itk::Size<2> size = {{imageSize, imageSize}};
+  itk::ImageRegion<2> fullRegion(corner, size);
+
+  vectorImage->SetRegions(fullRegion);
+  vectorImage->SetNumberOfComponentsPerPixel(pixelDimension);
+  vectorImage->Allocate();
+
+  fixedLengthImage->SetRegions(fullRegion);
+  fixedLengthImage->Allocate();
+
+  variableLengthImage->SetRegions(fullRegion);
+  variableLengthImage->Allocate();
+
+  // Iterate over any one of the images (we just want the indices)
+  itk::ImageRegionIteratorWithIndex<VectorImageType> imageIterator(vectorImage, vectorImage->GetLargestPossibleRegion());
+
+  while(!imageIterator.IsAtEnd())
+    {
+    itk::Index<2> index = imageIterator.GetIndex();
+
+    VectorImageType::PixelType p_vectorImage;
+    p_vectorImage.SetSize(pixelDimension);
+
+    ImageVariableLengthType::PixelType p_variableLengthImage;
+    p_variableLengthImage.SetSize(pixelDimension);
+
+    ImageFixedLengthType::PixelType p_fixedLengthImage;
+
+    for(unsigned int i = 0; i < pixelDimension; ++i)
+      {
+      float value = drand48();
+      p_fixedLengthImage[i] = value;
+      p_variableLengthImage[i] = value;
+      p_vectorImage[i] = value;
+      }
+
+    fixedLengthImage->SetPixel(index, p_fixedLengthImage);
+    variableLengthImage->SetPixel(index, p_variableLengthImage);
+    vectorImage->SetPixel(index, p_vectorImage);
+
+    ++imageIterator;
+    }
+
+}
+
+} // end namespace VectorImageVsImageCovariantVector
+
+#endif
@@ -0,0 +1,465 @@
+#include "PlanarImage.h"
+#include "VariableLengthVectorArena.h"
+#include "VectorImageDistances.h"
+#include "VectorImageVsImageCovariantVector.h"
+
+#include "BenchmarkRegistry.h"
+#include "DoNotOptimize.h"
+
+// STL
+#include <numeric>
+#include <string>
+#include <vector>
+
+using namespace VectorImageVsImageCovariantVector;
+
+namespace
+{
+
+/** The region of the images of CreateImages(). */
+itk::ImageRegion<2> GetImageRegion()
+{
+  itk::Index<2> corner = {{0,0}};
+  itk::Size<2> size = {{imageSize, imageSize}};
+  return itk::ImageRegion<2>(corner, size);
+}
+
+/** The images of CreateImages(), one at a time, for the cases that read only one of them. The components are
+ *  drawn in the same order, so they are the ones CreateImages() would give. */
+ImageFixedLengthType::Pointer CreateFixedLengthImage()
+{
+  ImageFixedLengthType::Pointer image = ImageFixedLengthType::New();
+  image->SetRegions(GetImageRegion());
+  image->Allocate();
+
+  ImageFixedLengthType::PixelType* const pixels = image->GetBufferPointer();
+  for(size_t pixel = 0; pixel < image->GetBufferedRegion().GetNumberOfPixels(); ++pixel)
+    {
+    for(unsigned int i = 0; i < pixelDimension; ++i)
+      {
+      pixels[pixel][i] = drand48();
+      }
+    }
+  return image;
+}
+
+ImageVariableLengthType::Pointer CreateVariableLengthImage()
+{
+  ImageVariableLengthType::Pointer image = ImageVariableLengthType::New();
+  image->SetRegions(GetImageRegion());
+  image->Allocate();
+
+  ImageVariableLengthType::PixelType* const pixels = image->GetBufferPointer();
+  for(size_t pixel = 0; pixel < image->GetBufferedRegion().GetNumberOfPixels(); ++pixel)
+    {
+    pixels[pixel].SetSize(pixelDimension);
+    for(unsigned int i = 0; i < pixelDimension; ++i)
+      {
+      pixels[pixel][i] = drand48();
+      }
+    }
+  return image;
+}
+
+/** Also with another number of components than the images of CreateImages(). */
+VectorImageType::Pointer CreateVectorImage(const unsigned int numberOfComponents = pixelDimension)
+{
+  VectorImageType::Pointer image = VectorImageType::New();
+  image->SetRegions(GetImageRegion());
+  image->SetNumberOfComponentsPerPixel(numberOfComponents);
+  image->Allocate();
+
+  float* const buffer = image->GetBufferPointer();
+  for(size_t i = 0; i < image->GetBufferedRegion().GetNumberOfPixels() * numberOfComponents; ++i)
+    {
+    buffer[i] = drand48();
+    }
+  return image;
+}
+
+template <typename TImage>
+void CompareImageCase(BenchmarkState& state, TImage* const image)
+{
+  state.SetItemsPerIteration(image->GetLargestPossibleRegion().GetNumberOfPixels());
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    totalDifference = CompareImage(image);
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+template <typename TImage>
+void CompareImageRowSpansCase(BenchmarkState& state, const TImage* const image)
+{
+  state.SetItemsPerIteration(image->GetLargestPossibleRegion().GetNumberOfPixels());
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    totalDifference = CompareImageRowSpans(image);
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+void ImageCovariantVectorCase(BenchmarkState& state)
+{
+  const ImageFixedLengthType::Pointer fixedLengthImage = CreateFixedLengthImage();
+
+  CompareImageCase(state, fixedLengthImage.GetPointer());
+}
+
+void ImageVariableLengthVectorCase(BenchmarkState& state)
+{
+  const ImageVariableLengthType::Pointer variableLengthImage = CreateVariableLengthImage();
+
+  CompareImageCase(state, variableLengthImage.GetPointer());
+}
+
+void VectorImageCase(BenchmarkState& state)
+{
+  const VectorImageType::Pointer vectorImage = CreateVectorImage();
+
+  CompareImageCase(state, vectorImage.GetPointer());
+}
+
+/** A copy of 'source' whose pixels are views of 'arena'. */
+void CreateArenaImage(const ImageVariableLengthType* const source, ImageVariableLengthType* const image,
+                      VariableLengthVectorArena<float>& arena)
+{
+  arena.Allocate(image, source->GetBufferedRegion(), pixelDimension);
+
+  const ImageVariableLengthType::PixelType* const sourcePixels = source->GetBufferPointer();
+  ImageVariableLengthType::PixelType* const pixels = image->GetBufferPointer();
+  for(size_t pixel = 0; pixel < source->GetBufferedRegion().GetNumberOfPixels(); ++pixel)
+    {
+    pixels[pixel] = sourcePixels[pixel];
+    }
+}
+
+void ImageVariableLengthVectorArenaCase(BenchmarkState& state)
+{
+  const ImageVariableLengthType::Pointer variableLengthImage = CreateVariableLengthImage();
+
+  VariableLengthVectorArena<float> arena;
+  ImageVariableLengthType::Pointer arenaImage = ImageVariableLengthType::New();
+  CreateArenaImage(variableLengthImage, arenaImage, arena);
+
+  CompareImageCase(state, arenaImage.GetPointer());
+}
+
+/** Allocating an Image<VariableLengthVector>, giving every pixel its components and freeing it again, with a
+ *  heap allocation per pixel or in an arena. */
+template <bool TArena>
+void CreateVariableLengthVectorImageCase(BenchmarkState& state)
+{
+  const itk::ImageRegion<2> region = GetImageRegion();
+  const size_t numberOfPixels = region.GetNumberOfPixels();
+
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * pixelDimension * sizeof(float));
+
+  float firstComponent = 0.0f;
+  while(state.KeepRunning())
+    {
+    // Declared before the image, so it is destroyed after it
+    VariableLengthVectorArena<float> arena;
+    ImageVariableLengthType::Pointer image = ImageVariableLengthType::New();
+    if(TArena)
+      {
+      arena.Allocate(image.GetPointer(), region, pixelDimension);
+      }
+    else
+      {
+      image->SetRegions(region);
+      image->Allocate();
+      }
+
+    ImageVariableLengthType::PixelType* const pixels = image->GetBufferPointer();
+    for(size_t pixel = 0; pixel < numberOfPixels; ++pixel)
+      {
+      if(!TArena)
+        {
+        pixels[pixel].SetSize(pixelDimension);
+        }
+      pixels[pixel].Fill(1.0f);
+      }
+    firstComponent = pixels[0][0];
+    DoNotOptimize(pixels);
+    ClobberMemory();
+    }
+  state.SetChecksum(firstComponent);
+}
+
+void ImageCovariantVectorRowSpansCase(BenchmarkState& state)
+{
+  const ImageFixedLengthType::Pointer fixedLengthImage = CreateFixedLengthImage();
+
+  CompareImageRowSpansCase(state, fixedLengthImage.GetPointer());
+}
+
+void ImageVariableLengthVectorRowSpansCase(BenchmarkState& state)
+{
+  const ImageVariableLengthType::Pointer variableLengthImage = CreateVariableLengthImage();
+
+  CompareImageRowSpansCase(state, variableLengthImage.GetPointer());
+}
+
+void ImageVariableLengthVectorArenaRowSpansCase(BenchmarkState& state)
+{
+  const ImageVariableLengthType::Pointer variableLengthImage = CreateVariableLengthImage();
+
+  VariableLengthVectorArena<float> arena;
+  ImageVariableLengthType::Pointer arenaImage = ImageVariableLengthType::New();
+  CreateArenaImage(variableLengthImage, arenaImage, arena);
+
+  CompareImageRowSpansCase(state, arenaImage.GetPointer());
+}
+
+void VectorImageRowSpansCase(BenchmarkState& state)
+{
+  const VectorImageType::Pointer vectorImage = CreateVectorImage();
+
+  CompareImageRowSpansCase(state, vectorImage.GetPointer());
+}
+
+void VectorImageRowSpansDispatchedCase(BenchmarkState& state)
+{
+  const VectorImageType::Pointer vectorImage = CreateVectorImage();
+
+  state.SetItemsPerIteration(vectorImage->GetLargestPossibleRegion().GetNumberOfPixels());
+
+  float totalDifference = 0.0f;
+  while(state.KeepRunning())
+    {
+    totalDifference = CompareImageRowSpansDispatched(vectorImage.GetPointer());
+    DoNotOptimize(totalDifference);
+    }
+  state.SetChecksum(totalDifference);
+}
+
+/** The distances from the first pixel; their sum is the checksum. */
+template <DistanceNorm TNorm, PatchDistance::InstructionSet TInstructionSet, bool TParallel>
+void DistancesCase(BenchmarkState& state)
+{
+  const VectorImageType::Pointer vectorImage = CreateVectorImage();
+
+  const size_t numberOfPixels = vectorImage->GetBufferedRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * vectorImage->GetNumberOfComponentsPerPixel() * sizeof(float));
+
+  const std::vector<float> reference(vectorImage->GetBufferPointer(),
+                                     vectorImage->GetBufferPointer() + vectorImage->GetNumberOfComponentsPerPixel());
+  std::vector<float> distances;
+  ThreadPool pool(TParallel ? state.GetNumberOfThreads() : 1);
+  while(state.KeepRunning())
+    {
+    if(TParallel)
+      {
+      ComputeDistancesParallel(vectorImage.GetPointer(), &reference[0], TNorm, TInstructionSet, distances, pool);
+      }
+    else
+      {
+      ComputeDistances(vectorImage.GetPointer(), &reference[0], TNorm, TInstructionSet, distances);
+      }
+    DoNotOptimize(&distances[0]);
+    ClobberMemory();
+    }
+  state.SetChecksum(std::accumulate(distances.begin(), distances.end(), 0.0));
+}
+
+/** The plain loop kernels, with the number of components known at runtime only or dispatched to a compiled
+ *  kernel. */
+template <DistanceNorm TNorm, unsigned int VNumberOfComponents, bool TDispatched>
+void LoopDistancesCase(BenchmarkState& state)
+{
+  const VectorImageType::Pointer vectorImage = CreateVectorImage(VNumberOfComponents);
+
+  const size_t numberOfPixels = vectorImage->GetBufferedRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * VNumberOfComponents * sizeof(float));
+
+  const std::vector<float> reference(vectorImage->GetBufferPointer(),
+                                     vectorImage->GetBufferPointer() + VNumberOfComponents);
+  std::vector<float> distances(numberOfPixels);
+  while(state.KeepRunning())
+    {
+    if(TDispatched)
+      {
+      ComputeDistancesDispatched(vectorImage.GetPointer(), &reference[0], TNorm, distances);
+      }
+    else
+      {
+      ComputeDistances<TNorm>(vectorImage->GetBufferPointer(), numberOfPixels,
+                              RuntimeComponentCount(VNumberOfComponents), &reference[0], &distances[0]);
+      }
+    DoNotOptimize(&distances[0]);
+    ClobberMemory();
+    }
+  state.SetChecksum(std::accumulate(distances.begin(), distances.end(), 0.0));
+}
+
+/** The same pixels interleaved (VectorImage) or planar, read a component, two components or every component of a
+ *  pixel at a time. */
+enum AccessPattern
+{
+  OneComponent,
+  TwoComponents,
+  AllComponents
+};
+
+template <AccessPattern TAccessPattern, bool TPlanar>
+void LayoutCase(BenchmarkState& state)
+{
+  const VectorImageType::Pointer vectorImage = CreateVectorImage();
+  PlanarImageType planarImage;
+  ConvertToPlanar(vectorImage.GetPointer(), planarImage);
+
+  const size_t numberOfPixels = vectorImage->GetBufferedRegion().GetNumberOfPixels();
+  const size_t componentsPerPixel = TAccessPattern == OneComponent ? 1 : TAccessPattern == TwoComponents ? 2 : pixelDimension;
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(numberOfPixels * componentsPerPixel * sizeof(float));
+
+  const std::vector<float> reference(vectorImage->GetBufferPointer(), vectorImage->GetBufferPointer() + pixelDimension);
+  std::vector<float> distances;
+  double checksum = 0.0;
+  while(state.KeepRunning())
+    {
+    switch(TAccessPattern)
+      {
+      case OneComponent:
+        checksum = TPlanar ? SumComponent(planarImage, pixelDimension / 2) :
+                             SumComponent(vectorImage.GetPointer(), pixelDimension / 2);
+        break;
+      case TwoComponents:
+        checksum = TPlanar ? SumAbsoluteComponentDifference(planarImage, 0, 1) :
+                             SumAbsoluteComponentDifference(vectorImage.GetPointer(), 0, 1);
+        break;
+      case AllComponents:
+        if(TPlanar)
+          {
+          ComputeDistances(planarImage, &reference[0], L2Distance, distances);
+          }
+        else
+          {
+          ComputeDistancesDispatched(vectorImage.GetPointer(), &reference[0], L2Distance, distances);
+          }
+        DoNotOptimize(&distances[0]);
+        ClobberMemory();
+        checksum = distances.back();
+        break;
+      }
+    DoNotOptimize(checksum);
+    }
+
+  if(TAccessPattern == AllComponents)
+    {
+    checksum = std::accumulate(distances.begin(), distances.end(), 0.0);
+    }
+  state.SetChecksum(checksum);
+}
+
+void ToPlanarCase(BenchmarkState& state)
+{
+  const VectorImageType::Pointer vectorImage = CreateVectorImage();
+
+  const size_t numberOfPixels = vectorImage->GetBufferedRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(2 * numberOfPixels * pixelDimension * sizeof(float));
+
+  PlanarImageType planarImage;
+  while(state.KeepRunning())
+    {
+    ConvertToPlanar(vectorImage.GetPointer(), planarImage);
+    DoNotOptimize(planarImage.GetPlane(0));
+    ClobberMemory();
+    }
+  state.SetChecksum(SumComponent(planarImage, pixelDimension - 1));
+}
+
+void ToInterleavedCase(BenchmarkState& state)
+{
+  const VectorImageType::Pointer vectorImage = CreateVectorImage();
+  PlanarImageType planarImage;
+  ConvertToPlanar(vectorImage.GetPointer(), planarImage);
+
+  const size_t numberOfPixels = vectorImage->GetBufferedRegion().GetNumberOfPixels();
+  state.SetItemsPerIteration(numberOfPixels);
+  state.SetBytesPerIteration(2 * numberOfPixels * pixelDimension * sizeof(float));
+
+  VectorImageType::Pointer interleavedImage = VectorImageType::New();
+  while(state.KeepRunning())
+    {
+    ConvertToInterleaved(planarImage, interleavedImage.GetPointer());
+    DoNotOptimize(interleavedImage->GetBufferPointer());
+    ClobberMemory();
+    }
+  state.SetChecksum(SumComponent(interleavedImage.GetPointer(), pixelDimension - 1));
+}
+
+template <PatchDistance::InstructionSet TInstructionSet>
+void RegisterDistancesInstructionSet(BenchmarkRegistry& registry)
+{
+  if(!PatchDistance::IsInstructionSetSupported(TInstructionSet))
+    {
+    return;
+    }
+
+  const std::string instructionSetName = PatchDistance::GetInstructionSetName(TInstructionSet);
+  registry.Add("VectorImageVsImageCovariantVector/Distances/L1/" + instructionSetName,
+               DistancesCase<L1Distance, TInstructionSet, false>);
+  registry.Add("VectorImageVsImageCovariantVector/Distances/L2/" + instructionSetName,
+               DistancesCase<L2Distance, TInstructionSet, false>);
+  registry.AddMultiThreaded("VectorImageVsImageCovariantVector/DistancesParallel/L2/" + instructionSetName,
+                            DistancesCase<L2Distance, TInstructionSet, true>);
+}
+
+} // end anonymous namespace
+
+void RegisterVectorImageVsImageCovariantVectorBenchmarks(BenchmarkRegistry& registry)
+{
+  registry.Add("VectorImageVsImageCovariantVector/ImageCovariantVector", ImageCovariantVectorCase);
+  registry.Add("VectorImageVsImageCovariantVector/ImageVariableLengthVector", ImageVariableLengthVectorCase);
+  registry.Add("VectorImageVsImageCovariantVector/ImageVariableLengthVectorArena", ImageVariableLengthVectorArenaCase);
+  registry.Add("VectorImageVsImageCovariantVector/VectorImage", VectorImageCase);
+  registry.Add("VectorImageVsImageCovariantVector/RowSpans/ImageCovariantVector", ImageCovariantVectorRowSpansCase);
+  registry.Add("VectorImageVsImageCovariantVector/RowSpans/ImageVariableLengthVector",
+               ImageVariableLengthVectorRowSpansCase);
+  registry.Add("VectorImageVsImageCovariantVector/RowSpans/ImageVariableLengthVectorArena",
+               ImageVariableLengthVectorArenaRowSpansCase);
+  registry.Add("VectorImageVsImageCovariantVector/RowSpans/VectorImage", VectorImageRowSpansCase);
+  registry.Add("VectorImageVsImageCovariantVector/RowSpans/VectorImageDispatched", VectorImageRowSpansDispatchedCase);
+
+  RegisterDistancesInstructionSet<PatchDistance::Scalar>(registry);
+  RegisterDistancesInstructionSet<PatchDistance::SSE>(registry);
+  RegisterDistancesInstructionSet<PatchDistance::AVX2>(registry);
+
+  registry.Add("VectorImageVsImageCovariantVector/Distances/L1/Loops/100Components",
+               LoopDistancesCase<L1Distance, pixelDimension, false>);
+  registry.Add("VectorImageVsImageCovariantVector/Distances/L2/Loops/100Components",
+               LoopDistancesCase<L2Distance, pixelDimension, false>);
+  registry.Add("VectorImageVsImageCovariantVector/Distances/L2/Loops/4Components", LoopDistancesCase<L2Distance, 4, false>);
+  registry.Add("VectorImageVsImageCovariantVector/Distances/L1/LoopsDispatched/100Components",
+               LoopDistancesCase<L1Distance, pixelDimension, true>);
+  registry.Add("VectorImageVsImageCovariantVector/Distances/L2/LoopsDispatched/100Components",
+               LoopDistancesCase<L2Distance, pixelDimension, true>);
+  registry.Add("VectorImageVsImageCovariantVector/Distances/L2/LoopsDispatched/4Components",
+               LoopDistancesCase<L2Distance, 4, true>);
+
+  registry.Add("VectorImageVsImageCovariantVector/Layout/OneComponent/Interleaved", LayoutCase<OneComponent, false>);
+  registry.Add("VectorImageVsImageCovariantVector/Layout/OneComponent/Planar", LayoutCase<OneComponent, true>);
+  registry.Add("VectorImageVsImageCovariantVector/Layout/TwoComponents/Interleaved", LayoutCase<TwoComponents, false>);
+  registry.Add("VectorImageVsImageCovariantVector/Layout/TwoComponents/Planar", LayoutCase<TwoComponents, true>);
+  registry.Add("VectorImageVsImageCovariantVector/Layout/AllComponents/Interleaved", LayoutCase<AllComponents, false>);
+  registry.Add("VectorImageVsImageCovariantVector/Layout/AllComponents/Planar", LayoutCase<AllComponents, true>);
+  registry.Add("VectorImageVsImageCovariantVector/Layout/ToPlanar", ToPlanarCase);
+  registry.Add("VectorImageVsImageCovariantVector/Layout/ToInterleaved", ToInterleavedCase);
+
+  registry.Add("VectorImageVsImageCovariantVector/Create/ImageVariableLengthVector",
+               CreateVariableLengthVectorImageCase<false>);
+  registry.Add("VectorImageVsImageCovariantVector/Create/ImageVariableLengthVectorArena",
+               CreateVariableLengthVectorImageCase<true>);
+}